@@ -0,0 +1,291 @@
+/**
+ * Benchmarks of the marching loops, the array accessors and the grid.
+ *
+ * The counters:
+ *
+ *   cells/s: CEs on the even plane marched (or SEs accessed) per second.
+ *   bytes/cell: bytes of the coordinate, so0, so1 and CFL arrays per CE,
+ *     which a time step streams through at least once.
+ *
+ * Run, e.g., benchmarks --benchmark_filter=march to select a group.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+
+#include "spacetime.hpp"
+
+namespace st = spacetime;
+
+namespace
+{
+
+constexpr int64_t NCELM_MIN = 1 << 8;
+constexpr int64_t NCELM_MAX = 1 << 18;
+
+/**
+ * Hooks of the linear scalar equation, so that Solver marches the same
+ * problem as LinearScalarSolver through std::function.
+ */
+void set_linear_scalar_kernel(st::Kernel & kernel)
+{
+    kernel.xn_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = 0.5 * (se.x() + se.xneg()) - se.xctr();
+        return se.dxneg() * (se.so0(iv) + displacement * se.so1(iv));
+    };
+    kernel.xp_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = 0.5 * (se.x() + se.xpos()) - se.xctr();
+        return se.dxpos() * (se.so0(iv) + displacement * se.so1(iv));
+    };
+    kernel.tn_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = se.x() - se.xctr();
+        return se.hdt() * (se.so0(iv) + (displacement + se.qdt()) * se.so1(iv));
+    };
+    kernel.tp_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = se.x() - se.xctr();
+        return se.hdt() * (se.so0(iv) + (displacement - se.qdt()) * se.so1(iv));
+    };
+    kernel.so0p_calc() = [](st::Selm const & se, size_t iv)
+    {
+        return se.so0(iv) + (se.x() - se.xctr() - se.hdt()) * se.so1(iv);
+    };
+    kernel.cfl_updater() = [](st::Selm & se)
+    {
+        se.cfl() = se.hdt() / std::min(se.dxneg(), se.dxpos());
+    };
+}
+
+template< typename ST > std::shared_ptr<ST> construct(std::shared_ptr<st::Grid> const & grid, double dt)
+{
+    return ST::construct(grid, dt);
+}
+
+template<> std::shared_ptr<st::Solver> construct<st::Solver>(std::shared_ptr<st::Grid> const & grid, double dt)
+{
+    std::shared_ptr<st::Solver> sol = st::Solver::construct(grid, dt, 1);
+    set_linear_scalar_kernel(sol->kernel());
+    return sol;
+}
+
+/**
+ * Solver with a sine wave offset from zero, so that the CFL number of the
+ * inviscid Burgers equation stays below 1.
+ */
+template< typename ST >
+std::shared_ptr<ST> make_solver(size_t ncelm, bool geometry=false)
+{
+    std::shared_ptr<st::Grid> grid = st::Grid::construct(0, 2*M_PI, ncelm);
+    if (geometry) { grid->build_geometry(); }
+    const double dt = 0.4 * 2*M_PI / ncelm;
+    std::shared_ptr<ST> sol = construct<ST>(grid, dt);
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        se.so0(0) = 1 + 0.5 * std::sin(se.x());
+        se.so1(0) = 0.5 * std::cos(se.x());
+    }
+    sol->setup_march();
+    return sol;
+}
+
+template< typename ST >
+double bytes_per_cell(ST const & sol)
+{
+    const size_t xsize = sol.grid().xsize();
+    const size_t nbyte = xsize * sizeof(double) * (2 + 2 * sol.nvar());
+    return static_cast<double>(nbyte) / sol.grid().ncelm();
+}
+
+/**
+ * Bytes per CE of a member: the coordinate array shared by the members, and
+ * the so0, so1 and CFL arrays of all members.
+ */
+template< typename ET >
+double ensemble_bytes_per_cell(ET const & ens)
+{
+    const size_t xsize = ens.grid().xsize();
+    const size_t nbyte = xsize * sizeof(st::real_type)
+                       + (ens.so0().size() + ens.so1().size() + ens.cfl().size()) * sizeof(typename ET::value_type);
+    return static_cast<double>(nbyte) / (ens.grid().ncelm() * ens.nmember());
+}
+
+void set_counters(benchmark::State & state, size_t ncelm, double cell_bytes)
+{
+    const double ncell = static_cast<double>(ncelm) * state.iterations();
+    state.counters["cells/s"] = benchmark::Counter(ncell, benchmark::Counter::kIsRate);
+    state.counters["bytes/cell"] = cell_bytes;
+    state.SetBytesProcessed(static_cast<int64_t>(ncell * cell_bytes));
+}
+
+template< typename ST, size_t ALPHA >
+void BM_march_alpha(benchmark::State & state)
+{
+    const size_t ncelm = state.range(0);
+    std::shared_ptr<ST> sol = make_solver<ST>(ncelm);
+    for (auto _ : state)
+    {
+        sol->template march_alpha<ALPHA>(1);
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, ncelm, bytes_per_cell(*sol));
+}
+
+#define ST_BENCHMARK_MARCH(ST, ALPHA) \
+    BENCHMARK_TEMPLATE(BM_march_alpha, ST, ALPHA)->RangeMultiplier(4)->Range(NCELM_MIN, NCELM_MAX);
+
+ST_BENCHMARK_MARCH(st::Solver, 0)
+ST_BENCHMARK_MARCH(st::Solver, 1)
+ST_BENCHMARK_MARCH(st::Solver, 2)
+ST_BENCHMARK_MARCH(st::LinearScalarSolver, 0)
+ST_BENCHMARK_MARCH(st::LinearScalarSolver, 1)
+ST_BENCHMARK_MARCH(st::LinearScalarSolver, 2)
+ST_BENCHMARK_MARCH(st::InviscidBurgersSolver, 0)
+ST_BENCHMARK_MARCH(st::InviscidBurgersSolver, 1)
+ST_BENCHMARK_MARCH(st::InviscidBurgersSolver, 2)
+
+#undef ST_BENCHMARK_MARCH
+
+/**
+ * March by the element-free sweep, with the geometry cache of the grid if the
+ * second argument is 1.
+ */
+template< typename ST, size_t ALPHA >
+void BM_march_sweep_alpha(benchmark::State & state)
+{
+    const size_t ncelm = state.range(0);
+    std::shared_ptr<ST> sol = make_solver<ST>(ncelm, state.range(1));
+    sol->set_use_sweep(true);
+    for (auto _ : state)
+    {
+        sol->template march_alpha<ALPHA>(1);
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, ncelm, bytes_per_cell(*sol));
+}
+
+#define ST_BENCHMARK_MARCH_SWEEP(ST, ALPHA) \
+    BENCHMARK_TEMPLATE(BM_march_sweep_alpha, ST, ALPHA) \
+        ->ArgsProduct({benchmark::CreateRange(NCELM_MIN, NCELM_MAX, 16), {0, 1}});
+
+ST_BENCHMARK_MARCH_SWEEP(st::LinearScalarSolver, 2)
+ST_BENCHMARK_MARCH_SWEEP(st::InviscidBurgersSolver, 2)
+
+#undef ST_BENCHMARK_MARCH_SWEEP
+
+/**
+ * March an ensemble of 64 members in double, float, or float calculated in
+ * double.  A cell is a CE of a member.
+ */
+template< typename ET >
+void BM_march_ensemble(benchmark::State & state)
+{
+    constexpr size_t nmember = 64;
+    const size_t ncelm = state.range(0);
+    std::shared_ptr<st::Grid> grid = st::Grid::construct(0, 2*M_PI, ncelm);
+    std::shared_ptr<ET> ens = ET::construct(grid, nmember, 0.4 * 2*M_PI / ncelm);
+    typename ET::array_type so0(std::vector<size_t>{grid->nselm()});
+    typename ET::array_type so1(std::vector<size_t>{grid->nselm()});
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        const double x = grid->xcoord()[st::Grid::BOUND_COUNT + (it << 1)];
+        so0[it] = 1 + 0.5 * std::sin(x);
+        so1[it] = 0.5 * std::cos(x);
+    }
+    for (size_t im=0; im<nmember; ++im)
+    {
+        ens->set_so0(im, so0, false);
+        ens->set_so1(im, so1, false);
+    }
+    ens->setup_march();
+    for (auto _ : state)
+    {
+        ens->template march_alpha<2>(1);
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, ncelm * nmember, ensemble_bytes_per_cell(*ens));
+}
+
+BENCHMARK_TEMPLATE(BM_march_ensemble, st::LinearScalarEnsemble)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX >> 4);
+BENCHMARK_TEMPLATE(BM_march_ensemble, st::LinearScalarEnsembleF32)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX >> 4);
+BENCHMARK_TEMPLATE(BM_march_ensemble, st::LinearScalarEnsembleMixed)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX >> 4);
+
+void BM_get_so0(benchmark::State & state)
+{
+    std::shared_ptr<st::LinearScalarSolver> sol = make_solver<st::LinearScalarSolver>(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sol->get_so0(0, false));
+    }
+    set_counters(state, sol->grid().nselm(), sizeof(double));
+}
+BENCHMARK(BM_get_so0)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX);
+
+void BM_set_so0(benchmark::State & state)
+{
+    std::shared_ptr<st::LinearScalarSolver> sol = make_solver<st::LinearScalarSolver>(state.range(0));
+    const st::Grid::array_type arr = sol->get_so0(0, false);
+    for (auto _ : state)
+    {
+        sol->set_so0(0, arr, false);
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, sol->grid().nselm(), sizeof(double));
+}
+BENCHMARK(BM_set_so0)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX);
+
+void BM_get_so1(benchmark::State & state)
+{
+    std::shared_ptr<st::LinearScalarSolver> sol = make_solver<st::LinearScalarSolver>(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sol->get_so1(0, false));
+    }
+    set_counters(state, sol->grid().nselm(), sizeof(double));
+}
+BENCHMARK(BM_get_so1)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX);
+
+void BM_get_cfl(benchmark::State & state)
+{
+    std::shared_ptr<st::LinearScalarSolver> sol = make_solver<st::LinearScalarSolver>(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sol->get_cfl(false));
+    }
+    set_counters(state, sol->grid().nselm(), sizeof(double));
+}
+BENCHMARK(BM_get_cfl)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX);
+
+void BM_grid_construct(benchmark::State & state)
+{
+    const size_t ncelm = state.range(0);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(st::Grid::construct(0, 1, ncelm));
+    }
+    set_counters(state, ncelm, sizeof(double) * 2);
+}
+BENCHMARK(BM_grid_construct)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX);
+
+void BM_grid_clone(benchmark::State & state)
+{
+    const size_t ncelm = state.range(0);
+    std::shared_ptr<st::Grid> grid = st::Grid::construct(0, 1, ncelm);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(grid->clone());
+    }
+    set_counters(state, ncelm, sizeof(double) * 2);
+}
+BENCHMARK(BM_grid_clone)->RangeMultiplier(16)->Range(NCELM_MIN, NCELM_MAX);
+
+} /* end namespace */
+
+BENCHMARK_MAIN();
+
+// vim: set et sw=4 ts=4:
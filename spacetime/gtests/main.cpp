@@ -1,5 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+
 #include "spacetime.hpp"
 
 
@@ -30,6 +39,17 @@ TEST(CopyTest, Solver)
 
 }
 
+TEST(GridTest, MaxNcelm)
+{
+
+    // The last coordinate index fits in sindex_type.
+    const size_t xsize = 2*st::Grid::max_ncelm() + 1 + 2*st::Grid::BOUND_COUNT;
+    EXPECT_GE(static_cast<size_t>(std::numeric_limits<st::sindex_type>::max()), xsize - 1);
+    EXPECT_LT(static_cast<size_t>(std::numeric_limits<st::sindex_type>::max()), xsize + 1);
+    EXPECT_THROW(st::Grid::construct(0, 1, st::Grid::max_ncelm() + 1), std::overflow_error);
+
+}
+
 TEST(SolverTest, Celm)
 {
 
@@ -47,6 +67,1578 @@ TEST(SolverTest, Celm)
 
 }
 
+namespace
+{
+
+void set_linear_scalar_kernel(st::Kernel & kernel)
+{
+    kernel.xn_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = 0.5 * (se.x() + se.xneg()) - se.xctr();
+        return se.dxneg() * (se.so0(iv) + displacement * se.so1(iv));
+    };
+    kernel.xp_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = 0.5 * (se.x() + se.xpos()) - se.xctr();
+        return se.dxpos() * (se.so0(iv) + displacement * se.so1(iv));
+    };
+    kernel.tn_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = se.x() - se.xctr();
+        return se.hdt() * (se.so0(iv) + (displacement + se.qdt()) * se.so1(iv));
+    };
+    kernel.tp_calc() = [](st::Selm const & se, size_t iv)
+    {
+        const double displacement = se.x() - se.xctr();
+        return se.hdt() * (se.so0(iv) + (displacement - se.qdt()) * se.so1(iv));
+    };
+    kernel.so0p_calc() = [](st::Selm const & se, size_t iv)
+    {
+        return se.so0(iv) + (se.x() - se.xctr() - se.hdt()) * se.so1(iv);
+    };
+}
+
+struct LinearScalarPolicy
+  : public st::KernelPolicy
+{
+
+    static double xn(st::Selm const & se, size_t iv)
+    {
+        const double displacement = 0.5 * (se.x() + se.xneg()) - se.xctr();
+        return se.dxneg() * (se.so0(iv) + displacement * se.so1(iv));
+    }
+
+    static double xp(st::Selm const & se, size_t iv)
+    {
+        const double displacement = 0.5 * (se.x() + se.xpos()) - se.xctr();
+        return se.dxpos() * (se.so0(iv) + displacement * se.so1(iv));
+    }
+
+    static double tn(st::Selm const & se, size_t iv)
+    {
+        const double displacement = se.x() - se.xctr();
+        double ret = se.so0(iv);
+        ret += displacement * se.so1(iv);
+        ret += se.qdt() * se.so1(iv);
+        return se.hdt() * ret;
+    }
+
+    static double tp(st::Selm const & se, size_t iv)
+    {
+        const double displacement = se.x() - se.xctr();
+        double ret = se.so0(iv);
+        ret += displacement * se.so1(iv);
+        ret -= se.qdt() * se.so1(iv);
+        return se.hdt() * ret;
+    }
+
+    static double so0p(st::Selm const & se, size_t iv)
+    {
+        double ret = se.so0(iv);
+        ret += (se.x()-se.xctr()) * se.so1(iv);
+        ret -= se.hdt() * se.so1(iv);
+        return ret;
+    }
+
+    static void update_cfl(st::Selm & se)
+    {
+        const double hdx = std::min(se.dxneg(), se.dxpos());
+        se.cfl() = se.hdt() / hdx;
+    }
+
+}; /* end struct LinearScalarPolicy */
+
+} /* end namespace */
+
+TEST(SolverTest, PolicyMatchesLinearScalar)
+{
+
+    constexpr size_t ncelm = 64;
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    const double dt = 0.5 * 2*M_PI / ncelm;
+
+    auto psol = st::PolicySolver<LinearScalarPolicy>::construct(grid, dt, 1);
+    auto lsol = st::LinearScalarSolver::construct(grid, dt);
+
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        const double x = psol->selm(it, false).x();
+        psol->selm(it, false).so0(0) = lsol->selm(it, false).so0(0) = std::sin(x);
+        psol->selm(it, false).so1(0) = lsol->selm(it, false).so1(0) = std::cos(x);
+    }
+    psol->setup_march();
+    lsol->setup_march();
+
+    psol->march_alpha<2>(10);
+    lsol->march_alpha<2>(10);
+
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        EXPECT_EQ(lsol->selm(it, false).so0(0), psol->selm(it, false).so0(0));
+        EXPECT_EQ(lsol->selm(it, false).so1(0), psol->selm(it, false).so1(0));
+        EXPECT_EQ(lsol->selm(it, false).cfl(), psol->selm(it, false).cfl());
+    }
+
+}
+
+TEST(SolverTest, KernelPlaneHooks)
+{
+
+    constexpr size_t ncelm = 64;
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    const double dt = 0.5 * 2*M_PI / ncelm;
+
+    std::shared_ptr<st::Solver> sol=st::Solver::construct(grid, dt, 1);
+    std::shared_ptr<st::LinearScalarSolver> lsol=st::LinearScalarSolver::construct(grid, dt);
+
+    // Evaluate the per-element policy over a whole plane.
+    auto make_plane = [](double (*calc)(st::Selm const &, size_t))
+    {
+        return [calc](st::Field const & field, bool odd_plane, st::Kernel::array_type & ret)
+        {
+            const size_t xbegin = st::Kernel::plane_xbegin(odd_plane);
+            const size_t nelm = st::Kernel::plane_size(field.grid(), odd_plane);
+            const st::sindex_type start = odd_plane ? -1 : 0;
+            for (size_t it=0; it<nelm; ++it)
+            {
+                st::Selm const se = field.selm<st::Selm>(start + it, odd_plane);
+                ret(xbegin + 2*it, 0) = calc(se, 0);
+            }
+        };
+    };
+    sol->kernel().xn_plane_calc() = make_plane(&LinearScalarPolicy::xn);
+    sol->kernel().xp_plane_calc() = make_plane(&LinearScalarPolicy::xp);
+    sol->kernel().tn_plane_calc() = make_plane(&LinearScalarPolicy::tn);
+    sol->kernel().tp_plane_calc() = make_plane(&LinearScalarPolicy::tp);
+    sol->kernel().so0p_plane_calc() = make_plane(&LinearScalarPolicy::so0p);
+    sol->kernel().cfl_plane_updater() = [](st::Field & field, bool odd_plane)
+    {
+        const st::sindex_type start = odd_plane ? -1 : 0;
+        const size_t nelm = st::Kernel::plane_size(field.grid(), odd_plane);
+        for (size_t it=0; it<nelm; ++it)
+        {
+            st::Selm se = field.selm<st::Selm>(start + it, odd_plane);
+            LinearScalarPolicy::update_cfl(se);
+        }
+    };
+
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        const double x = sol->selm(it, false).x();
+        sol->selm(it, false).so0(0) = lsol->selm(it, false).so0(0) = std::sin(x);
+        sol->selm(it, false).so1(0) = lsol->selm(it, false).so1(0) = std::cos(x);
+    }
+    sol->setup_march();
+    lsol->setup_march();
+
+    // Outside a half step the plane hooks are evaluated on demand.
+    EXPECT_DOUBLE_EQ(lsol->selm(3, false).xn(0), sol->selm(3, false).xn(0));
+    EXPECT_DOUBLE_EQ(lsol->selm(3, true).tp(0), sol->selm(3, true).tp(0));
+
+    sol->march_alpha<2>(10);
+    lsol->march_alpha<2>(10);
+
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        EXPECT_DOUBLE_EQ(lsol->selm(it, false).so0(0), sol->selm(it, false).so0(0));
+        EXPECT_DOUBLE_EQ(lsol->selm(it, false).cfl(), sol->selm(it, false).cfl());
+    }
+    for (bool odd_plane : {false, true})
+    {
+        const st::Kernel::array_type lso0p = lsol->get_so0p(0, odd_plane);
+        const st::Kernel::array_type so0p = sol->get_so0p(0, odd_plane);
+        for (size_t it=0; it<lso0p.size(); ++it) { EXPECT_DOUBLE_EQ(lso0p[it], so0p[it]); }
+        EXPECT_DOUBLE_EQ(lsol->selm(5, odd_plane).xp(0), sol->selm(5, odd_plane).xp(0));
+    }
+
+    // Resetting the kernel drops the plane hooks.
+    sol->kernel().reset();
+    EXPECT_FALSE(static_cast<bool>(sol->kernel().xn_plane_calc()));
+    EXPECT_EQ(0.0, sol->selm(0, false).xn(0));
+
+}
+
+TEST(SolverTest, KernelPlaneOnDemand)
+{
+
+    std::shared_ptr<st::Solver> sol=st::Solver::construct(st::Grid::construct(0, 1, 16), 0.01, 1);
+    size_t ncall = 0;
+    sol->kernel().xn_plane_calc() = [&ncall](st::Field const & field, bool odd_plane, st::Kernel::array_type & ret)
+    {
+        ++ncall;
+        const size_t xbegin = st::Kernel::plane_xbegin(odd_plane);
+        const size_t nelm = st::Kernel::plane_size(field.grid(), odd_plane);
+        for (size_t it=0; it<nelm; ++it) { ret(xbegin + 2*it, 0) = field.so0(xbegin + 2*it, 0); }
+    };
+    st::Kernel::array_type arr(std::vector<size_t>{sol->grid().nselm()});
+    for (size_t it=0; it<arr.size(); ++it) { arr[it] = it; }
+    sol->set_so0(0, arr, false);
+
+    // One evaluation serves all the SEs on a plane.
+    for (size_t it=0; it<sol->grid().nselm(); ++it) { EXPECT_EQ(it, sol->selm(it, false).xn(0)); }
+    EXPECT_EQ(1u, ncall);
+    sol->selm(0, true).xn(0);
+    EXPECT_EQ(2u, ncall);
+
+    // Setting the solution drops the result.
+    for (size_t it=0; it<arr.size(); ++it) { arr[it] = 2 * it; }
+    sol->set_so0(0, arr, false);
+    EXPECT_EQ(6, sol->selm(3, false).xn(0));
+    EXPECT_EQ(3u, ncall);
+
+    // So does a copy of the field, which has its own solution.
+    std::shared_ptr<st::Solver> other=sol->clone();
+    EXPECT_EQ(6, other->selm(3, false).xn(0));
+    EXPECT_EQ(4u, ncall);
+
+}
+
+namespace
+{
+
+template< typename ST >
+std::shared_ptr<ST> make_sine_solver(size_t ncelm)
+{
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    const double dt = 0.5 * 2*M_PI / ncelm;
+
+    std::shared_ptr<ST> sol=ST::construct(grid, dt);
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        const double x = sol->selm(it, false).x();
+        sol->selm(it, false).so0(0) = std::sin(x);
+        sol->selm(it, false).so1(0) = std::cos(x);
+    }
+    sol->setup_march();
+    return sol;
+}
+
+template< typename ST >
+void expect_same_solution(ST const & sol0, ST const & sol1)
+{
+    for (size_t it=0; it<sol0.grid().xsize(); ++it)
+    {
+        EXPECT_EQ(sol0.so0()(it, 0), sol1.so0()(it, 0));
+        EXPECT_EQ(sol0.so1()(it, 0), sol1.so1()(it, 0));
+        EXPECT_EQ(sol0.cfl()(it), sol1.cfl()(it));
+    }
+}
+
+/**
+ * March the sine wave by a solver and by its clone set up by config(), and
+ * expect the bit-identical solution.
+ */
+template< typename ST, size_t ALPHA, typename F >
+void check_march_config(size_t ncelm, size_t steps, F && config)
+{
+    std::shared_ptr<ST> ref=make_sine_solver<ST>(ncelm);
+    std::shared_ptr<ST> sol=ref->clone();
+    config(*sol);
+
+    ref->template march_alpha<ALPHA>(steps);
+    sol->template march_alpha<ALPHA>(steps);
+
+    expect_same_solution(*ref, *sol);
+}
+
+template< typename ST >
+void check_threaded_march(size_t ncelm, size_t nthread)
+{
+    check_march_config<ST, 2>(ncelm, 20, [nthread](ST & sol)
+    {
+        sol.set_nthread(nthread);
+        EXPECT_EQ(nthread, sol.nthread());
+    });
+}
+
+template< typename ST, size_t ALPHA >
+void check_sweep_march(size_t ncelm, size_t nthread)
+{
+    EXPECT_TRUE(ST::has_sweep());
+    check_march_config<ST, ALPHA>(ncelm, 20, [nthread](ST & sol)
+    {
+        sol.set_use_sweep(true);
+        sol.set_nthread(nthread);
+    });
+}
+
+template< typename ST, size_t ALPHA >
+void check_fused_march(size_t ncelm, size_t nthread, bool use_sweep)
+{
+    check_march_config<ST, ALPHA>(ncelm, 20, [nthread, use_sweep](ST & sol)
+    {
+        sol.set_use_fused(true);
+        sol.set_use_sweep(use_sweep);
+        sol.set_nthread(nthread);
+    });
+}
+
+template< typename ST, size_t ALPHA >
+void check_block_march(size_t ncelm, size_t block_steps, size_t tile_ncelm, size_t nthread, bool use_sweep)
+{
+    check_march_config<ST, ALPHA>(ncelm, 23, [=](ST & sol)
+    {
+        sol.set_block_steps(block_steps);
+        sol.set_tile_ncelm(tile_ncelm);
+        sol.set_use_sweep(use_sweep);
+        sol.set_nthread(nthread);
+    });
+}
+
+} /* end namespace */
+
+TEST(ParallelTest, StaticChunk)
+{
+
+    // Chunks cover the interval without overlap and start at aligned offsets.
+    for (size_t nthread : {1, 2, 3, 7})
+    {
+        st::sindex_type next = -1;
+        for (size_t ithread=0; ithread<nthread; ++ithread)
+        {
+            auto range = st::static_chunk(-1, 1000, ithread, nthread, 4);
+            EXPECT_EQ(next, range.first);
+            EXPECT_EQ(0, (range.first + 1) % 4);
+            next = range.second;
+        }
+        EXPECT_EQ(1000, next);
+    }
+
+}
+
+TEST(ParallelTest, MarchBitIdentical)
+{
+
+    check_threaded_march<st::LinearScalarSolver>(10001, 4);
+    check_threaded_march<st::InviscidBurgersSolver>(10001, 4);
+    check_threaded_march<st::InviscidBurgersSolver>(3, 8);
+
+}
+
+TEST(ParallelTest, Exception)
+{
+
+    // An exception thrown in a thread propagates to the caller.
+    for (size_t nthread : {1, 4})
+    {
+        EXPECT_THROW(st::parallel_for(0, 1000, nthread, 1, [](st::sindex_type it)
+        {
+            if (it == 600) { throw std::runtime_error("body"); }
+        }), std::runtime_error);
+        EXPECT_THROW((st::parallel_reduce_chunk<int>(0, 1000, nthread, 1, [](st::sindex_type begin, st::sindex_type end)
+        {
+            if (begin <= 600 && 600 < end) { throw std::runtime_error("body"); }
+            return end - begin;
+        }, [](int a, int b) { return a + b; })), std::runtime_error);
+    }
+
+    // So does an exception thrown by a kernel hook of Solver.
+    std::shared_ptr<st::Solver> sol=st::Solver::construct(st::Grid::construct(0, 100, 100), 1, 1);
+    sol->set_nthread(4);
+    sol->kernel().xn_calc() = [](st::Selm const &, size_t) -> double { throw std::runtime_error("hook"); };
+    EXPECT_THROW(sol->march_half_so0(false), std::runtime_error);
+
+}
+
+TEST(SweepTest, MarchBitIdentical)
+{
+
+    check_sweep_march<st::LinearScalarSolver, 0>(1001, 1);
+    check_sweep_march<st::LinearScalarSolver, 2>(1001, 3);
+    check_sweep_march<st::InviscidBurgersSolver, 1>(1001, 1);
+    check_sweep_march<st::InviscidBurgersSolver, 2>(1001, 3);
+
+    EXPECT_FALSE(st::Solver::has_sweep());
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 100, 100);
+    std::shared_ptr<st::Solver> sol=st::Solver::construct(grid, 1, 1);
+    EXPECT_THROW(sol->set_use_sweep(true), std::invalid_argument);
+
+}
+
+TEST(SweepTest, FusedBitIdentical)
+{
+
+    check_fused_march<st::LinearScalarSolver, 2>(1001, 1, false);
+    check_fused_march<st::LinearScalarSolver, 2>(1001, 1, true);
+    check_fused_march<st::InviscidBurgersSolver, 1>(1001, 3, false);
+    check_fused_march<st::InviscidBurgersSolver, 2>(1001, 3, true);
+    check_fused_march<st::InviscidBurgersSolver, 2>(3, 8, true);
+
+}
+
+TEST(SweepTest, BlockBitIdentical)
+{
+
+    check_block_march<st::LinearScalarSolver, 2>(1001, 4, 16, 1, false);
+    check_block_march<st::LinearScalarSolver, 2>(1001, 8, 0, 1, true);
+    check_block_march<st::InviscidBurgersSolver, 1>(1000, 5, 33, 3, false);
+    check_block_march<st::InviscidBurgersSolver, 2>(1001, 4, 11, 4, true);
+    // Grid narrower than a tile.
+    check_block_march<st::InviscidBurgersSolver, 2>(7, 4, 0, 1, true);
+
+}
+
+namespace
+{
+
+template< typename ET, typename ST, size_t ALPHA >
+void check_ensemble_march(size_t ncelm, size_t nthread, st::Boundary const & bnd)
+{
+    constexpr size_t nmember = 5;
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    const double dt = 0.4 * 2*M_PI / ncelm;
+    std::shared_ptr<ET> ens=ET::construct(grid, nmember, dt);
+    ens->set_left_boundary(bnd);
+    ens->set_right_boundary(bnd);
+    ens->set_nthread(nthread);
+    std::vector<std::shared_ptr<ST>> sols;
+    for (size_t im=0; im<nmember; ++im)
+    {
+        const double mdt = dt * (1 - 0.1*im);
+        std::shared_ptr<ST> sol=ST::construct(grid, mdt);
+        sol->set_left_boundary(bnd);
+        sol->set_right_boundary(bnd);
+        st::Grid::array_type so0(std::vector<size_t>{grid->nselm()});
+        st::Grid::array_type so1(std::vector<size_t>{grid->nselm()});
+        for (size_t it=0; it<grid->nselm(); ++it)
+        {
+            const double x = sol->selm(it, false).x();
+            so0[it] = 1 + 0.2*(im+1)*std::sin(x);
+            so1[it] = 0.2*(im+1)*std::cos(x);
+        }
+        sol->set_so0(0, so0, false);
+        sol->set_so1(0, so1, false);
+        sol->setup_march();
+        ens->set_so0(im, so0, false);
+        ens->set_so1(im, so1, false);
+        ens->set_time_increment(im, mdt);
+        sols.push_back(sol);
+    }
+    ens->setup_march();
+    ens->template march_alpha<ALPHA>(20);
+    EXPECT_EQ(20, ens->step());
+    for (size_t im=0; im<nmember; ++im)
+    {
+        sols[im]->template march_alpha<ALPHA>(20);
+        for (size_t it=0; it<grid->xsize(); ++it)
+        {
+            EXPECT_EQ(sols[im]->so0()(it, 0), ens->so0()(it, im));
+            EXPECT_EQ(sols[im]->so1()(it, 0), ens->so1()(it, im));
+        }
+        EXPECT_EQ(sols[im]->cfl_max(), ens->cfl_max(im));
+    }
+}
+
+} /* end namespace */
+
+TEST(SweepTest, EnsembleBitIdentical)
+{
+
+    check_ensemble_march<st::LinearScalarEnsemble, st::LinearScalarSolver, 2>(200, 1, st::Boundary::periodic());
+    check_ensemble_march<st::InviscidBurgersEnsemble, st::InviscidBurgersSolver, 1>(200, 3, st::Boundary::extrapolate());
+    check_ensemble_march<st::InviscidBurgersEnsemble, st::InviscidBurgersSolver, 2>(201, 2, st::Boundary::reflect());
+
+    std::shared_ptr<st::LinearScalarEnsemble> ens=st::LinearScalarEnsemble::construct(st::Grid::construct(0, 1, 10), 4, 0.01);
+    EXPECT_THROW(ens->set_time_increment(4, 0.01), std::out_of_range);
+    EXPECT_THROW(ens->get_so0(4, false), std::out_of_range);
+    EXPECT_THROW(ens->set_left_boundary(st::Boundary::dirichlet({1, 2})), std::invalid_argument);
+
+}
+
+namespace
+{
+
+/**
+ * March an ensemble stored in float (ET) and the double ensemble (DT) from
+ * the same initial condition, and compare the solution.
+ */
+template< typename ET, typename DT, size_t ALPHA >
+void check_ensemble_precision(size_t ncelm, st::Boundary const & bnd, double tol)
+{
+    constexpr size_t nmember = 3;
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    const double dt = 0.4 * 2*M_PI / ncelm;
+    std::shared_ptr<ET> ens=ET::construct(grid, nmember, dt);
+    std::shared_ptr<DT> dens=DT::construct(grid, nmember, dt);
+    typename ET::array_type so0(std::vector<size_t>{grid->nselm()});
+    typename ET::array_type so1(std::vector<size_t>{grid->nselm()});
+    typename DT::array_type dso0(std::vector<size_t>{grid->nselm()});
+    typename DT::array_type dso1(std::vector<size_t>{grid->nselm()});
+    for (size_t im=0; im<nmember; ++im)
+    {
+        for (size_t it=0; it<grid->nselm(); ++it)
+        {
+            const double x = grid->xcoord()[st::Grid::BOUND_COUNT + (it << 1)];
+            so0[it] = static_cast<float>(1 + 0.2*(im+1)*std::sin(x));
+            so1[it] = static_cast<float>(0.2*(im+1)*std::cos(x));
+            dso0[it] = so0[it];
+            dso1[it] = so1[it];
+        }
+        ens->set_so0(im, so0, false);
+        ens->set_so1(im, so1, false);
+        dens->set_so0(im, dso0, false);
+        dens->set_so1(im, dso1, false);
+    }
+    ens->set_left_boundary(bnd);
+    ens->set_right_boundary(bnd);
+    dens->set_left_boundary(bnd);
+    dens->set_right_boundary(bnd);
+    ens->setup_march();
+    dens->setup_march();
+    ens->template march_alpha<ALPHA>(40);
+    dens->template march_alpha<ALPHA>(40);
+    double err0 = 0;
+    double err1 = 0;
+    for (size_t im=0; im<nmember; ++im)
+    {
+        for (size_t it=0; it<grid->xsize(); ++it)
+        {
+            err0 = std::max(err0, std::fabs(dens->so0()(it, im) - ens->so0()(it, im)));
+            err1 = std::max(err1, std::fabs(dens->so1()(it, im) - ens->so1()(it, im)));
+        }
+        EXPECT_NEAR(dens->cfl_max(im), ens->cfl_max(im), tol);
+    }
+    EXPECT_LT(err0, tol);
+    // so1 is a difference of so0 over dx.
+    EXPECT_LT(err1, tol * ncelm / (2*M_PI));
+}
+
+} /* end namespace */
+
+TEST(SweepTest, EnsemblePrecision)
+{
+
+    check_ensemble_precision<st::LinearScalarEnsembleF32, st::LinearScalarEnsemble, 2>(200, st::Boundary::periodic(), 1.e-5);
+    check_ensemble_precision<st::LinearScalarEnsembleMixed, st::LinearScalarEnsemble, 2>(200, st::Boundary::periodic(), 1.e-5);
+    check_ensemble_precision<st::InviscidBurgersEnsembleF32, st::InviscidBurgersEnsemble, 1>(200, st::Boundary::extrapolate(), 1.e-5);
+    check_ensemble_precision<st::InviscidBurgersEnsembleMixed, st::InviscidBurgersEnsemble, 1>(200, st::Boundary::extrapolate(), 1.e-5);
+
+}
+
+namespace
+{
+
+/**
+ * March the sweep solvers stored in double and in float (FS) and the solver
+ * ST from the same initial condition.  The double one matches ST bit by bit,
+ * and the float one within tol.
+ */
+template< typename FS, typename ST, size_t ALPHA >
+void check_sweep_solver(size_t ncelm, size_t nthread, st::Boundary const & bnd, double tol)
+{
+    using DS = st::SweepSolver<typename FS::flux_type>;
+    std::shared_ptr<ST> ref=make_sine_solver<ST>(ncelm);
+    ref->set_left_boundary(bnd);
+    ref->set_right_boundary(bnd);
+    std::shared_ptr<DS> dsol=DS::construct(ref->grid().shared_from_this(), ref->time_increment());
+    std::shared_ptr<FS> fsol=FS::construct(ref->grid().shared_from_this(), ref->time_increment());
+    dsol->set_so0(0, ref->get_so0(0, false), false);
+    dsol->set_so1(0, ref->get_so1(0, false), false);
+    typename FS::array_type so0(std::vector<size_t>{ref->grid().nselm()});
+    typename FS::array_type so1(std::vector<size_t>{ref->grid().nselm()});
+    for (size_t it=0; it<so0.size(); ++it)
+    {
+        so0[it] = static_cast<float>(ref->get_so0(0, false)[it]);
+        so1[it] = static_cast<float>(ref->get_so1(0, false)[it]);
+    }
+    fsol->set_so0(0, so0, false);
+    fsol->set_so1(0, so1, false);
+    dsol->set_left_boundary(bnd);
+    dsol->set_right_boundary(bnd);
+    fsol->set_left_boundary(bnd);
+    fsol->set_right_boundary(bnd);
+    dsol->set_nthread(nthread);
+    fsol->set_nthread(nthread);
+    ref->setup_march();
+    dsol->setup_march();
+    fsol->setup_march();
+    EXPECT_EQ(ref->cfl_max(), dsol->cfl_max());
+
+    ref->template march_alpha<ALPHA>(40);
+    dsol->template march_alpha<ALPHA>(40);
+    fsol->template march_alpha<ALPHA>(40);
+    EXPECT_EQ(40, fsol->step());
+    double err0 = 0;
+    double err1 = 0;
+    for (size_t it=0; it<ref->grid().xsize(); ++it)
+    {
+        EXPECT_EQ(ref->so0()(it, 0), dsol->so0()(it, 0));
+        EXPECT_EQ(ref->so1()(it, 0), dsol->so1()(it, 0));
+        err0 = std::max(err0, std::fabs(ref->so0()(it, 0) - fsol->so0()(it, 0)));
+        err1 = std::max(err1, std::fabs(ref->so1()(it, 0) - fsol->so1()(it, 0)));
+    }
+    EXPECT_EQ(ref->cfl_max(), dsol->cfl_max());
+    EXPECT_NEAR(ref->cfl_max(), fsol->cfl_max(), tol);
+    EXPECT_LT(err0, tol);
+    // so1 is a difference of so0 over dx.
+    EXPECT_LT(err1, tol * ncelm / (2*M_PI));
+}
+
+} /* end namespace */
+
+TEST(SweepTest, SolverF32)
+{
+
+    check_sweep_solver<st::LinearScalarSolverF32, st::LinearScalarSolver, 2>(200, 1, st::Boundary::periodic(), 1.e-5);
+    check_sweep_solver<st::InviscidBurgersSolverF32, st::InviscidBurgersSolver, 1>(200, 3, st::Boundary::extrapolate(), 1.e-5);
+    check_sweep_solver<st::InviscidBurgersSolverF32, st::InviscidBurgersSolver, 2>(201, 2, st::Boundary::reflect(), 1.e-5);
+
+    std::shared_ptr<st::LinearScalarSolverF32> sol=st::LinearScalarSolverF32::construct(st::Grid::construct(0, 1, 10), 0.01);
+    EXPECT_EQ(1u, sol->nvar());
+    EXPECT_THROW(sol->get_so0(1, false), std::out_of_range);
+    EXPECT_THROW(sol->set_so0(0, st::LinearScalarSolverF32::array_type(std::vector<size_t>{3}), false), std::out_of_range);
+    EXPECT_THROW(sol->set_left_boundary(st::Boundary::dirichlet({1, 2})), std::invalid_argument);
+    EXPECT_THROW(sol->set_left_boundary(st::Boundary::callback([](st::Selm &, st::Selm const &, size_t) {})), std::invalid_argument);
+
+}
+
+namespace
+{
+
+template< typename ST, size_t ALPHA >
+void check_geometry_march(std::shared_ptr<st::Grid> const & grid, bool use_fused)
+{
+    std::shared_ptr<st::Grid> cached_grid=grid->clone();
+    cached_grid->build_geometry();
+    std::vector<std::shared_ptr<ST>> sols;
+    for (auto const & g : {grid, cached_grid})
+    {
+        std::shared_ptr<ST> sol=ST::construct(g, 1.e-3);
+        for (size_t it=0; it<g->nselm(); ++it)
+        {
+            auto se = sol->selm(it, false);
+            se.so0(0) = 1 + 0.5 * std::sin(2*M_PI*se.x());
+            se.so1(0) = M_PI * std::cos(2*M_PI*se.x());
+        }
+        sol->setup_march();
+        sols.push_back(sol);
+    }
+    sols[1]->set_use_sweep(true);
+    sols[1]->set_use_fused(use_fused);
+    for (auto & sol : sols) { sol->template march_alpha<ALPHA>(20); }
+    // Multiplying the reciprocals only changes the rounding.
+    for (size_t it=0; it<grid->xsize(); ++it)
+    {
+        EXPECT_NEAR(sols[0]->so0()(it, 0), sols[1]->so0()(it, 0), 1.e-12);
+        EXPECT_NEAR(sols[0]->so1()(it, 0), sols[1]->so1()(it, 0), 1.e-9);
+        EXPECT_NEAR(sols[0]->cfl()(it), sols[1]->cfl()(it), 1.e-12);
+    }
+}
+
+} /* end namespace */
+
+TEST(SweepTest, GeometryCache)
+{
+
+    constexpr size_t ncelm = 60;
+    st::Grid::array_type xloc(std::vector<size_t>{ncelm+1});
+    for (size_t it=0; it<=ncelm; ++it) { xloc[it] = std::pow(static_cast<double>(it) / ncelm, 1.5); }
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(xloc);
+    EXPECT_FALSE(grid->has_geometry());
+    EXPECT_THROW(grid->geometry(), std::runtime_error);
+
+    // The cached geometry is the same as that of the elements.
+    std::shared_ptr<st::Grid> cached_grid=grid->clone();
+    cached_grid->build_geometry();
+    EXPECT_TRUE(cached_grid->clone()->has_geometry());
+    EXPECT_TRUE(cached_grid->adapt(std::vector<int>(ncelm, 1))->has_geometry());
+    const st::Grid::Geometry geom = cached_grid->geometry();
+    using sweep_type = st::LinearScalarSolver::sweep_type;
+    std::shared_ptr<st::LinearScalarSolver> sol=st::LinearScalarSolver::construct(cached_grid, 1.e-3);
+    for (bool odd_plane : {false, true})
+    {
+        for (st::sindex_type is=(odd_plane ? -1 : 0); is<static_cast<st::sindex_type>(ncelm+1); ++is)
+        {
+            const auto se = sol->selm(is, odd_plane);
+            const size_t ix = sweep_type::xindex_selm(is, odd_plane);
+            EXPECT_EQ(se.xctr(), geom.xctr(ix));
+            EXPECT_EQ(se.x() - se.xctr(), geom.disp(ix));
+            EXPECT_EQ(0.5 * (se.x() + se.xneg()) - se.xctr(), geom.dispneg(ix));
+            EXPECT_EQ(0.5 * (se.x() + se.xpos()) - se.xctr(), geom.disppos(ix));
+            EXPECT_EQ(se.dxneg(), geom.dxneg(ix));
+            EXPECT_EQ(se.dxpos(), geom.dxpos(ix));
+            EXPECT_EQ(std::min(se.dxneg(), se.dxpos()), geom.hdx(ix));
+            EXPECT_DOUBLE_EQ(1.0, geom.div_dx(se.dx(), ix));
+        }
+    }
+    cached_grid->clear_geometry();
+    EXPECT_FALSE(cached_grid->has_geometry());
+
+    check_geometry_march<st::LinearScalarSolver, 2>(grid, false);
+    check_geometry_march<st::InviscidBurgersSolver, 1>(grid, false);
+    check_geometry_march<st::InviscidBurgersSolver, 2>(grid, true);
+
+}
+
+TEST(SolverTest, Boundary)
+{
+
+    std::shared_ptr<st::LinearScalarSolver> sol=make_sine_solver<st::LinearScalarSolver>(10);
+    const size_t ncelm = sol->grid().ncelm();
+    auto const left_in = sol->selm(0, true);
+    auto const left_out = sol->selm(-1, true);
+    auto const right_in = sol->selm(ncelm-1, true);
+    auto const right_out = sol->selm(ncelm, true);
+
+    sol->march_half1_alpha<2>();
+    EXPECT_EQ(right_in.so0(0), left_out.so0(0));
+    EXPECT_EQ(left_in.so1(0), right_out.so1(0));
+
+    sol->set_left_boundary(st::Boundary::reflect({-1.0}));
+    sol->set_right_boundary(st::Boundary::dirichlet({2.0}));
+    sol->march_half2_alpha<2>();
+    sol->march_half1_alpha<2>();
+    EXPECT_EQ(-left_in.so0(0), left_out.so0(0));
+    EXPECT_EQ(left_in.so1(0), left_out.so1(0));
+    EXPECT_EQ(2.0, right_out.so0(0));
+    EXPECT_EQ(0.0, right_out.so1(0));
+
+    sol->set_left_boundary(st::Boundary::extrapolate());
+    sol->set_right_boundary(st::Boundary::callback([](st::Selm & ghost, st::Selm const & inner, size_t order)
+    {
+        if (0 == order) { ghost.so0(0) = 3 * inner.so0(0); }
+        else { ghost.so1(0) = 4.0; }
+    }));
+    sol->march_half2_alpha<2>();
+    sol->march_half1_alpha<2>();
+    EXPECT_EQ(left_in.so0(0), left_out.so0(0));
+    EXPECT_EQ(left_in.so1(0), left_out.so1(0));
+    EXPECT_EQ(3 * right_in.so0(0), right_out.so0(0));
+    EXPECT_EQ(4.0, right_out.so1(0));
+
+    EXPECT_THROW(sol->set_left_boundary(st::Boundary::dirichlet({1.0, 2.0})), std::invalid_argument);
+    EXPECT_THROW(st::Boundary::callback(nullptr), std::invalid_argument);
+
+    // Fused and blocked marching treat the boundary the same way.
+    sol->set_left_boundary(st::Boundary::reflect());
+    sol->set_right_boundary(st::Boundary::extrapolate());
+    std::shared_ptr<st::LinearScalarSolver> blocked=sol->clone();
+    blocked->set_block_steps(3);
+    blocked->set_tile_ncelm(1);
+    sol->march_alpha<2>(7);
+    blocked->march_alpha<2>(7);
+    expect_same_solution(*sol, *blocked);
+
+}
+
+TEST(EulerTest, FluxJacobian)
+{
+
+    // The Euler flux is homogeneous of degree one: f(u) = A(u) u.
+    const double u[3] = {0.8, 0.3, 2.1};
+    double jac[3][3];
+    st::EulerFlux::jacobian(u, jac);
+    for (size_t iv=0; iv<3; ++iv)
+    {
+        const double au = jac[iv][0]*u[0] + jac[iv][1]*u[1] + jac[iv][2]*u[2];
+        EXPECT_NEAR(st::EulerFlux::flux(u, iv), au, 1.e-14);
+    }
+
+}
+
+namespace
+{
+
+/**
+ * Exact solution of the Riemann problem of a perfect gas at x/t = xi, as
+ * (rho, v, p).  The star pressure is found by Newton's iteration.
+ */
+struct RiemannState { double rho, v, p; };
+
+RiemannState exact_riemann(RiemannState const & l, RiemannState const & r, double gamma, double xi)
+{
+    const double cl = std::sqrt(gamma * l.p / l.rho);
+    const double cr = std::sqrt(gamma * r.p / r.rho);
+    // Pressure function of one side and its derivative.
+    auto side = [gamma](RiemannState const & s, double c, double p, double & dfdp)
+    {
+        if (p > s.p)
+        {
+            const double a = 2 / ((gamma + 1) * s.rho);
+            const double b = (gamma - 1) / (gamma + 1) * s.p;
+            const double q = std::sqrt(a / (p + b));
+            dfdp = q * (1 - (p - s.p) / (2 * (b + p)));
+            return (p - s.p) * q;
+        }
+        const double ratio = p / s.p;
+        dfdp = std::pow(ratio, -(gamma + 1) / (2 * gamma)) / (s.rho * c);
+        return 2 * c / (gamma - 1) * (std::pow(ratio, (gamma - 1) / (2 * gamma)) - 1);
+    };
+    double ps = 0.5 * (l.p + r.p);
+    double fl = 0, fr = 0;
+    for (size_t it=0; it<100; ++it)
+    {
+        double dl = 0, dr = 0;
+        fl = side(l, cl, ps, dl);
+        fr = side(r, cr, ps, dr);
+        const double dp = (fl + fr + r.v - l.v) / (dl + dr);
+        ps = std::max(ps - dp, 1.e-12);
+        if (std::abs(dp) < 1.e-14 * ps) { break; }
+    }
+    double dummy = 0;
+    fl = side(l, cl, ps, dummy);
+    fr = side(r, cr, ps, dummy);
+    const double vs = 0.5 * (l.v + r.v) + 0.5 * (fr - fl);
+    const double gm = (gamma - 1) / (gamma + 1);
+    auto star_rho = [gamma, gm, ps](RiemannState const & s)
+    {
+        if (ps > s.p) { return s.rho * (ps / s.p + gm) / (gm * ps / s.p + 1); }
+        return s.rho * std::pow(ps / s.p, 1 / gamma);
+    };
+    if (xi < vs)
+    {
+        if (ps > l.p)
+        {
+            const double sl = l.v - cl * std::sqrt((gamma + 1) / (2 * gamma) * ps / l.p + (gamma - 1) / (2 * gamma));
+            return xi < sl ? l : RiemannState{star_rho(l), vs, ps};
+        }
+        const double csl = cl * std::pow(ps / l.p, (gamma - 1) / (2 * gamma));
+        if (xi < l.v - cl) { return l; }
+        if (xi > vs - csl) { return RiemannState{star_rho(l), vs, ps}; }
+        const double v = 2 / (gamma + 1) * (cl + (gamma - 1) / 2 * l.v + xi);
+        const double rho = l.rho * std::pow(2 / (gamma + 1) + gm / cl * (l.v - xi), 2 / (gamma - 1));
+        return RiemannState{rho, v, l.p * std::pow(rho / l.rho, gamma)};
+    }
+    if (ps > r.p)
+    {
+        const double sr = r.v + cr * std::sqrt((gamma + 1) / (2 * gamma) * ps / r.p + (gamma - 1) / (2 * gamma));
+        return xi > sr ? r : RiemannState{star_rho(r), vs, ps};
+    }
+    const double csr = cr * std::pow(ps / r.p, (gamma - 1) / (2 * gamma));
+    if (xi > r.v + cr) { return r; }
+    if (xi < vs + csr) { return RiemannState{star_rho(r), vs, ps}; }
+    const double v = 2 / (gamma + 1) * (-cr + (gamma - 1) / 2 * r.v + xi);
+    const double rho = r.rho * std::pow(2 / (gamma + 1) - gm / cr * (r.v - xi), 2 / (gamma - 1));
+    return RiemannState{rho, v, r.p * std::pow(rho / r.rho, gamma)};
+}
+
+/**
+ * Euler solver set up for Sod's problem on [0, 1].
+ */
+std::shared_ptr<st::EulerSolver> make_sod_solver(size_t ncelm)
+{
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 1, ncelm);
+    std::shared_ptr<st::EulerSolver> sol=st::EulerSolver::construct(grid, 1.e-3);
+    sol->set_left_boundary(st::Boundary::extrapolate());
+    sol->set_right_boundary(st::Boundary::extrapolate());
+    const double gamma = st::EulerFlux::gamma();
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        const bool left = se.x() < 0.5;
+        se.so0(0) = left ? 1.0 : 0.125;
+        se.so0(1) = 0;
+        se.so0(2) = (left ? 1.0 : 0.1) / (gamma - 1);
+        for (size_t iv=0; iv<3; ++iv) { se.so1(iv) = 0; }
+    }
+    sol->setup_march();
+    return sol;
+}
+
+} /* end namespace */
+
+TEST(EulerTest, ShockTube)
+{
+
+    constexpr size_t ncelm = 200;
+    std::shared_ptr<st::EulerSolver> sol=make_sod_solver(ncelm);
+    st::Grid const & grid = sol->grid();
+    EXPECT_EQ(3, sol->nvar());
+    const double gamma = st::EulerFlux::gamma();
+    double mass0 = 0;
+    for (size_t it=0; it<grid.nselm(); ++it) { mass0 += sol->selm(it, false).so0(0); }
+
+    sol->march_alpha<1>(100);
+
+    double mass = 0;
+    double cflmax = 0;
+    for (size_t it=0; it<grid.nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        EXPECT_GT(se.so0(0), 0.1);
+        EXPECT_LT(se.so0(0), 1.01);
+        EXPECT_GT(se.so0(2), 0);
+        mass += se.so0(0);
+        cflmax = std::max(cflmax, se.cfl());
+    }
+    EXPECT_NEAR(mass0, mass, 1.e-6 * mass0);
+    EXPECT_LT(cflmax, 1);
+
+    // Compare with the exact solution at t = 0.2.
+    sol->march_alpha<1>(100);
+    const RiemannState left{1.0, 0.0, 1.0};
+    const RiemannState right{0.125, 0.0, 0.1};
+    const double time = 0.2;
+    double l1 = 0, maxerr_plateau = 0;
+    for (size_t it=0; it<grid.nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        const RiemannState gold = exact_riemann(left, right, gamma, (se.x() - 0.5) / time);
+        const double err = std::abs(se.so0(0) - gold.rho);
+        l1 += err / ncelm;
+        // The plateaus between the rarefaction tail and the contact, and
+        // between the contact and the shock.
+        if ((se.x() > 0.52 && se.x() < 0.66) || (se.x() > 0.71 && se.x() < 0.83))
+        {
+            maxerr_plateau = std::max(maxerr_plateau, err / gold.rho);
+        }
+    }
+    // The density is within 0.4% of the exact solution on the plateaus, and
+    // the L1 norm of its error is 0.0035.  Four digits are not reached at
+    // this resolution.
+    EXPECT_LT(maxerr_plateau, 1.e-2);
+    EXPECT_LT(l1, 1.e-2);
+    // The undisturbed ends.
+    EXPECT_DOUBLE_EQ(1.0, sol->selm(0, false).so0(0));
+    EXPECT_DOUBLE_EQ(0.125, sol->selm(ncelm, false).so0(0));
+
+}
+
+TEST(EulerTest, SweepBitIdentical)
+{
+
+    EXPECT_TRUE(st::EulerSolver::has_sweep());
+    auto check = [](auto && config)
+    {
+        std::shared_ptr<st::EulerSolver> ref=make_sod_solver(101);
+        std::shared_ptr<st::EulerSolver> sol=ref->clone();
+        config(*sol);
+        ref->march_alpha<1>(23);
+        sol->march_alpha<1>(23);
+        for (size_t it=0; it<ref->grid().xsize(); ++it)
+        {
+            for (size_t iv=0; iv<3; ++iv)
+            {
+                EXPECT_EQ(ref->so0()(it, iv), sol->so0()(it, iv));
+                EXPECT_EQ(ref->so1()(it, iv), sol->so1()(it, iv));
+            }
+            EXPECT_EQ(ref->cfl()(it), sol->cfl()(it));
+        }
+    };
+    check([](st::EulerSolver & sol) { sol.set_use_sweep(true); sol.set_nthread(3); });
+    check([](st::EulerSolver & sol) { sol.set_use_sweep(true); sol.set_use_fused(true); });
+    check([](st::EulerSolver & sol) { sol.set_use_sweep(true); sol.set_block_steps(4); sol.set_tile_ncelm(16); });
+
+}
+
+TEST(SolverTest, CflMax)
+{
+
+    std::shared_ptr<st::InviscidBurgersSolver> sol=make_sine_solver<st::InviscidBurgersSolver>(1001);
+    sol->march_alpha<2>(5);
+    sol->update_cfl(false);
+    double gold = 0;
+    for (size_t it=0; it<sol->grid().nselm(); ++it) { gold = std::max(gold, sol->selm(it, false).cfl()); }
+    EXPECT_EQ(gold, sol->cfl_max());
+
+    std::shared_ptr<st::InviscidBurgersSolver> other=sol->clone();
+    other->set_nthread(3);
+    other->set_use_sweep(true);
+    other->update_cfl(false);
+    EXPECT_EQ(gold, other->cfl_max());
+    other->set_use_fused(true);
+    other->march_half1_alpha<2>();
+    other->march_half2_alpha<2>();
+    sol->march_half1_alpha<2>();
+    sol->march_half2_alpha<2>();
+    EXPECT_EQ(sol->cfl_max(), other->cfl_max());
+
+}
+
+TEST(SolverTest, AdaptiveTimeStep)
+{
+
+    std::shared_ptr<st::InviscidBurgersSolver> sol=make_sine_solver<st::InviscidBurgersSolver>(1001);
+    sol->set_target_cfl(0.8);
+    const double dt0 = sol->time_increment();
+    sol->march_alpha<2>(1);
+    EXPECT_NE(dt0, sol->time_increment());
+    sol->march_alpha<2>(20);
+    // The smooth solution changes little in a step.
+    sol->update_cfl(false);
+    EXPECT_NEAR(0.8, sol->cfl_max(), 0.02);
+
+    // Adaptive stepping takes over temporal blocking.
+    std::shared_ptr<st::InviscidBurgersSolver> blocked=make_sine_solver<st::InviscidBurgersSolver>(1001);
+    blocked->set_target_cfl(0.8);
+    blocked->set_block_steps(4);
+    blocked->set_use_sweep(true);
+    blocked->march_alpha<2>(21);
+    EXPECT_EQ(sol->time_increment(), blocked->time_increment());
+
+    // A flow starting almost at rest grows the time increment gradually.
+    std::shared_ptr<st::InviscidBurgersSolver> rest=make_sine_solver<st::InviscidBurgersSolver>(101);
+    for (size_t it=0; it<rest->grid().nselm(); ++it)
+    {
+        rest->selm(it, false).so0(0) *= 1.e-8;
+        rest->selm(it, false).so1(0) *= 1.e-8;
+    }
+    rest->setup_march();
+    rest->set_target_cfl(0.8);
+    EXPECT_THROW(rest->set_max_dt_growth(0.5), std::invalid_argument);
+    double dt = rest->time_increment();
+    for (size_t it=0; it<10; ++it)
+    {
+        rest->march_alpha<2>(1);
+        EXPECT_DOUBLE_EQ(dt * rest->max_dt_growth(), rest->time_increment());
+        dt = rest->time_increment();
+    }
+    rest->set_max_time_increment(1.5 * dt);
+    rest->march_alpha<2>(5);
+    EXPECT_EQ(1.5 * dt, rest->time_increment());
+    for (size_t it=0; it<rest->grid().xsize(); ++it) { EXPECT_LT(std::abs(rest->so0()(it, 0)), 1.e-7); }
+
+}
+
+TEST(SolverTest, LocalTimeStepping)
+{
+
+    constexpr size_t ncelm = 64;
+    std::shared_ptr<st::LinearScalarSolver> gold=make_sine_solver<st::LinearScalarSolver>(ncelm);
+    EXPECT_THROW(gold->march_lts_alpha<1>(1), std::runtime_error);
+    EXPECT_THROW(gold->set_lts_coarse(std::vector<bool>(ncelm+1)), std::invalid_argument);
+
+    // A single rate is the same as the global time step.
+    std::shared_ptr<st::LinearScalarSolver> coarse=gold->clone();
+    coarse->set_lts_coarse(std::vector<bool>(ncelm, true));
+    std::shared_ptr<st::LinearScalarSolver> fine=gold->clone();
+    fine->set_lts_coarse(std::vector<bool>(ncelm, false));
+    std::shared_ptr<st::LinearScalarSolver> half=gold->clone();
+    half->set_time_increment(gold->time_increment() / 2);
+    gold->set_use_fused(true);
+    half->set_use_fused(true);
+    gold->march_alpha<1>(10);
+    coarse->march_lts_alpha<1>(10);
+    expect_same_solution(*gold, *coarse);
+    half->march_alpha<1>(20);
+    fine->march_lts_alpha<1>(10);
+    expect_same_solution(*half, *fine);
+
+    // Cells of the fine rate in the middle are half as wide as those at the
+    // two ends, and all cells take the same CFL number.
+    const size_t nend = 16;
+    const size_t nmid = 64;
+    st::Grid::array_type xloc(std::vector<size_t>{nmid + 2*nend + 1});
+    std::vector<bool> flags;
+    xloc[0] = 0;
+    for (size_t it=0; it<nmid + 2*nend; ++it)
+    {
+        const bool end = it < nend || it >= nend + nmid;
+        xloc[it+1] = xloc[it] + (end ? 2 : 1) * 2*M_PI / (nmid + 4*nend);
+        flags.push_back(end);
+    }
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(xloc);
+    std::shared_ptr<st::LinearScalarSolver> sol=st::LinearScalarSolver::construct(grid, 3.6 * M_PI / (nmid + 4*nend));
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        const double x = sol->selm(it, false).xctr();
+        sol->selm(it, false).so0(0) = std::sin(x);
+        sol->selm(it, false).so1(0) = std::cos(x);
+    }
+    sol->setup_march();
+    sol->set_lts_coarse(flags);
+    EXPECT_EQ(flags, sol->lts_coarse());
+    const auto amount = [&sol]()
+    {
+        const size_t n = sol->grid().ncelm();
+        double ret = sol->selm(0, false).xp(0) + sol->selm(n, false).xn(0);
+        for (size_t it=1; it<n; ++it)
+        {
+            auto se = sol->selm(it, false);
+            ret += se.so0(0) * (se.xpos() - se.xneg());
+        }
+        return ret;
+    };
+    const double amount0 = amount();
+    const size_t steps = 200;
+    sol->march_lts_alpha<1>(steps);
+    EXPECT_NEAR(amount0, amount(), 1.e-13);
+    EXPECT_NEAR(0.9, sol->cfl_max(), 1.e-12);
+    const double time = steps * sol->time_increment();
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        EXPECT_NEAR(std::sin(se.xctr() - time), se.so0(0), 2.e-2);
+    }
+
+}
+
+TEST(SolverTest, AdaptiveMeshRefinement)
+{
+
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 8, 8);
+    EXPECT_THROW(grid->adapt(std::vector<int>(7)), std::invalid_argument);
+    std::shared_ptr<st::Grid> adapted=grid->adapt({1, 0, -1, -1, -1, 1, -1, 0});
+    ASSERT_EQ(9, adapted->ncelm());
+    EXPECT_EQ(0, adapted->xmin());
+    EXPECT_EQ(8, adapted->xmax());
+    const std::vector<double> gold{0, 0.5, 1, 2, 4, 5, 5.5, 6, 7, 8};
+    for (size_t it=0; it<gold.size(); ++it)
+    {
+        EXPECT_EQ(gold[it], adapted->xcoord()[st::Grid::BOUND_COUNT + 2*it]);
+    }
+
+    // A linear solution is kept.
+    std::shared_ptr<st::LinearScalarSolver> sol=st::LinearScalarSolver::construct(grid, 0.5);
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        se.so0(0) = 2 * se.xctr() + 1;
+        se.so1(0) = 2;
+    }
+    sol->remesh(adapted);
+    EXPECT_EQ(adapted.get(), &sol->grid());
+    for (size_t it=0; it<adapted->nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        EXPECT_NEAR(2 * se.xctr() + 1, se.so0(0), 1.e-12);
+        EXPECT_NEAR(2, se.so1(0), 1.e-12);
+    }
+    EXPECT_THROW(sol->remesh(st::Grid::construct(0, 9, 8)), std::invalid_argument);
+
+    // A jump is refined, and the smooth parts are coarsened.  The solution is
+    // conserved.
+    std::shared_ptr<st::InviscidBurgersSolver> burgers=make_sine_solver<st::InviscidBurgersSolver>(128);
+    burgers->march_alpha<2>(80);
+    const auto amount = [&burgers]()
+    {
+        const size_t n = burgers->grid().ncelm();
+        double ret = burgers->selm(0, false).xp(0) + burgers->selm(n, false).xn(0);
+        for (size_t it=1; it<n; ++it)
+        {
+            auto se = burgers->selm(it, false);
+            ret += se.so0(0) * (se.xpos() - se.xneg());
+        }
+        return ret;
+    };
+    const double amount0 = amount();
+    const std::vector<int> flags = burgers->adapt_flags(0.2, 0.02);
+    ASSERT_EQ(128, flags.size());
+    // The shock forms at x = pi.
+    EXPECT_EQ(1, flags[63]);
+    EXPECT_EQ(1, flags[64]);
+    EXPECT_EQ(-1, flags[0]);
+    EXPECT_EQ(-1, flags[127]);
+    std::vector<int> const narrow = burgers->adapt_flags(0.2, 0.02, 2*M_PI/128, 2*M_PI/128);
+    EXPECT_EQ(0, std::count(narrow.begin(), narrow.end(), 1));
+    EXPECT_EQ(0, std::count(narrow.begin(), narrow.end(), -1));
+    burgers->adapt(flags);
+    EXPECT_NE(128, burgers->grid().ncelm());
+    EXPECT_NEAR(amount0, amount(), 1.e-13);
+    burgers->march_alpha<2>(20);
+    for (size_t it=0; it<burgers->grid().nselm(); ++it)
+    {
+        EXPECT_TRUE(std::isfinite(burgers->selm(it, false).so0(0)));
+    }
+
+}
+
+TEST(SolverTest, Checkpoint)
+{
+
+    const std::string path = ::testing::TempDir() + "libst_checkpoint.bin";
+    std::shared_ptr<st::EulerSolver> sol=st::EulerSolver::construct(st::Grid::construct(0, 1, 50), 0.004);
+    for (size_t it=0; it<sol->grid().nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        const bool left = se.xctr() < 0.5;
+        se.so0(0) = left ? 1.0 : 0.125;
+        se.so0(1) = 0;
+        se.so0(2) = (left ? 1.0 : 0.1) / 0.4;
+        for (size_t iv=0; iv<3; ++iv) { se.so1(iv) = 0; }
+    }
+    sol->setup_march();
+    sol->march_alpha<1>(10);
+    EXPECT_EQ(10, sol->step());
+    sol->write_checkpoint(path);
+
+    {
+        st::Checkpoint const ckpt(path);
+        EXPECT_EQ(st::Checkpoint::VERSION, ckpt.header().version);
+        EXPECT_EQ(50, ckpt.header().ncelm);
+        EXPECT_EQ(3, ckpt.header().nvar);
+        EXPECT_EQ(10, ckpt.header().step);
+        EXPECT_EQ(0, ckpt.header().offset[st::Checkpoint::SO0] % st::Checkpoint::ALIGNMENT);
+        EXPECT_EQ(sol->so1()(60, 1), ckpt.so1()[60*3+1]);
+    }
+
+    // Restore to a solver on another grid.
+    std::shared_ptr<st::EulerSolver> restored=st::EulerSolver::construct(st::Grid::construct(0, 2, 7), 1);
+    restored->read_checkpoint(path);
+    EXPECT_EQ(50, restored->grid().ncelm());
+    EXPECT_EQ(sol->time_increment(), restored->time_increment());
+    EXPECT_EQ(10, restored->step());
+    sol->march_alpha<1>(10);
+    restored->march_alpha<1>(10);
+    EXPECT_EQ(20, restored->step());
+    for (size_t it=0; it<sol->grid().xsize(); ++it)
+    {
+        for (size_t iv=0; iv<3; ++iv)
+        {
+            EXPECT_EQ(sol->so0()(it, iv), restored->so0()(it, iv));
+            EXPECT_EQ(sol->so1()(it, iv), restored->so1()(it, iv));
+        }
+    }
+
+    std::shared_ptr<st::LinearScalarSolver> other=make_sine_solver<st::LinearScalarSolver>(10);
+    EXPECT_THROW(other->read_checkpoint(path), std::invalid_argument);
+    {
+        std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekp(0);
+        stream.write("NOTACKPT", 8);
+    }
+    EXPECT_THROW(restored->read_checkpoint(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(restored->read_checkpoint(path), std::runtime_error);
+
+}
+
+TEST(SolverTest, SnapshotOutput)
+{
+
+    const std::string path = ::testing::TempDir() + "libst_snapshot.bin";
+    std::shared_ptr<st::LinearScalarSolver> sol=make_sine_solver<st::LinearScalarSolver>(40);
+    std::shared_ptr<st::LinearScalarSolver> ref=sol->clone();
+    sol->set_block_steps(4);
+    EXPECT_THROW(sol->set_output(std::make_shared<st::SnapshotWriter>(path), 0), std::invalid_argument);
+    sol->set_output(std::make_shared<st::SnapshotWriter>(path), 3);
+    EXPECT_EQ(nullptr, sol->clone()->output());
+    sol->march_alpha<2>(10);
+    sol->close_output();
+    EXPECT_EQ(nullptr, sol->output());
+    // Append to the file after the restart.
+    sol->set_output(std::make_shared<st::SnapshotWriter>(path, true), 3);
+    sol->march_alpha<2>(2);
+    sol->close_output();
+
+    st::SnapshotReader reader(path);
+    std::vector<size_t> steps;
+    while (reader.next())
+    {
+        steps.push_back(reader.header().step);
+        EXPECT_EQ(40, reader.header().ncelm);
+        EXPECT_EQ(1, reader.header().nvar);
+        ref->march_alpha<2>(3);
+        for (size_t it=0; it<ref->grid().xsize(); ++it)
+        {
+            EXPECT_EQ(ref->grid().xcoord()[it], reader.xcoord()[it]);
+            EXPECT_EQ(ref->so0()(it, 0), reader.so0()[it]);
+            EXPECT_EQ(ref->so1()(it, 0), reader.so1()[it]);
+        }
+    }
+    EXPECT_EQ((std::vector<size_t>{3, 6, 9, 12}), steps);
+    std::remove(path.c_str());
+
+}
+
+TEST(SolverTest, PlaceMemory)
+{
+
+    constexpr size_t ncelm = 1000;
+    std::vector<std::shared_ptr<st::InviscidBurgersSolver>> sols;
+    for (size_t isol=0; isol<2; ++isol)
+    {
+        std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+        std::shared_ptr<st::InviscidBurgersSolver> sol=st::InviscidBurgersSolver::construct(grid, 0.4 * 2*M_PI / ncelm);
+        sol->set_nthread(3);
+        for (size_t it=0; it<grid->nselm(); ++it)
+        {
+            auto se = sol->selm(it, false);
+            se.so0(0) = 1 + 0.5 * std::sin(se.x());
+            se.so1(0) = 0.5 * std::cos(se.x());
+        }
+        sol->setup_march();
+        sols.push_back(sol);
+    }
+
+    const st::Grid::array_type xcoord = sols[1]->grid().xcoord();
+    const st::Grid::array_type so0 = sols[1]->so0();
+    const std::shared_ptr<st::Grid::array_type const> held = sols[1]->shared_so0();
+    double const * old_data = sols[1]->so0().data();
+    double const * xdata = sols[1]->grid().xcoord().data();
+    auto const se = sols[1]->selm(3, false);
+    sols[1]->place_memory();
+    EXPECT_NE(old_data, sols[1]->so0().data());
+    // The grid is left alone, and an element taken before follows the field.
+    EXPECT_EQ(xdata, sols[1]->grid().xcoord().data());
+    EXPECT_EQ(sols[1]->grid().xcoord()[st::Grid::BOUND_COUNT + 6], se.x());
+    EXPECT_EQ(&sols[1]->so0()(st::Grid::BOUND_COUNT + 6, 0), &se.so0(0));
+    // The holder keeps the old array.
+    EXPECT_EQ(old_data, held->data());
+    EXPECT_EQ(so0[0], (*held)(0, 0));
+    for (size_t it=0; it<xcoord.size(); ++it)
+    {
+        EXPECT_EQ(xcoord[it], sols[1]->grid().xcoord()[it]);
+        EXPECT_EQ(so0[it], sols[1]->so0()(it, 0));
+    }
+    for (auto & sol : sols) { sol->march_alpha<2>(20); }
+    for (size_t it=0; it<xcoord.size(); ++it)
+    {
+        EXPECT_EQ(sols[0]->so0()(it, 0), sols[1]->so0()(it, 0));
+        EXPECT_EQ(sols[0]->so1()(it, 0), sols[1]->so1()(it, 0));
+        EXPECT_EQ(sols[0]->cfl()(it), sols[1]->cfl()(it));
+    }
+
+    // So does an ensemble.
+    std::shared_ptr<st::LinearScalarEnsemble> ens=st::LinearScalarEnsemble::construct(sols[0]->grid().clone(), 4, 0.01);
+    ens->so0()(3, 2) = 1.5;
+    const std::shared_ptr<st::LinearScalarEnsemble::array_type const> ens_held = ens->shared_so0();
+    ens->set_nthread(2);
+    ens->place_memory();
+    EXPECT_NE(ens_held.get(), ens->shared_so0().get());
+    EXPECT_EQ(1.5, (*ens_held)(3, 2));
+    EXPECT_EQ(1.5, ens->so0()(3, 2));
+
+    // The geometry cache is placed with the coordinates.
+    std::shared_ptr<st::Grid> grid=sols[0]->grid().clone();
+    grid->build_geometry();
+    const st::Grid::Geometry geom = grid->geometry();
+    std::vector<double> xctr, rdx;
+    for (size_t it=1; it<grid->xsize()-1; ++it)
+    {
+        xctr.push_back(geom.xctr(it));
+        rdx.push_back(geom.div_dx(1.0, it));
+    }
+    grid->place_memory(3, 4, true);
+    const st::Grid::Geometry placed_geom = grid->geometry();
+    for (size_t it=1; it<grid->xsize()-1; ++it)
+    {
+        EXPECT_EQ(xctr[it-1], placed_geom.xctr(it));
+        EXPECT_EQ(rdx[it-1], placed_geom.div_dx(1.0, it));
+    }
+
+    // Rows of CEs partitioned over the threads are all copied, also for
+    // blocks stacked along the first axis.
+    for (size_t nblock : {1, 3})
+    {
+        st::Grid::array_type arr(std::vector<size_t>{nblock*(2*ncelm+5), 3});
+        for (size_t it=0; it<arr.size(); ++it) { arr.data()[it] = static_cast<double>(it); }
+        for (size_t nthread : {1, 2, 7})
+        {
+            const st::Grid::array_type placed = st::place_rows(arr, ncelm, nthread, 5, false, nblock);
+            ASSERT_EQ(arr.size(), placed.size());
+            for (size_t it=0; it<arr.size(); ++it) { EXPECT_EQ(arr.data()[it], placed.data()[it]); }
+        }
+    }
+
+}
+
+TEST(SolverTest, Profile)
+{
+
+    using profiler_type = st::Profiler;
+    constexpr size_t ncelm = 40;
+    constexpr size_t steps = 5;
+    std::shared_ptr<st::LinearScalarSolver> sol=make_sine_solver<st::LinearScalarSolver>(ncelm);
+    sol->reset_profiler();
+    sol->march_alpha<1>(steps);
+    profiler_type const & prof = sol->profiler();
+    EXPECT_STREQ("boundary", profiler_type::phase_name(profiler_type::BOUNDARY));
+    EXPECT_THROW(prof.record(profiler_type::NPHASE), std::out_of_range);
+    if (!profiler_type::enabled())
+    {
+        for (size_t it=0; it<profiler_type::NPHASE; ++it)
+        {
+            EXPECT_EQ(0, prof.record(static_cast<profiler_type::Phase>(it)).ncall);
+        }
+        return;
+    }
+    EXPECT_EQ(2*steps, prof.record(profiler_type::SO0).ncall);
+    EXPECT_EQ(steps*(2*ncelm+1), prof.record(profiler_type::SO0).nelm);
+    EXPECT_EQ(2*steps, prof.record(profiler_type::CFL).ncall);
+    EXPECT_EQ(2*steps, prof.record(profiler_type::SO1).ncall);
+    EXPECT_EQ(2*steps, prof.record(profiler_type::BOUNDARY).ncall);
+    EXPECT_EQ(0, prof.record(profiler_type::FUSED).ncall);
+
+    // The boundary inside temporal blocking is counted in the block.
+    sol->reset_profiler();
+    sol->set_block_steps(steps);
+    sol->march_alpha<1>(steps);
+    EXPECT_EQ(1, prof.record(profiler_type::BLOCK).ncall);
+    EXPECT_EQ(0, prof.record(profiler_type::BOUNDARY).ncall);
+    EXPECT_LT(0, prof.record(profiler_type::BLOCK).seconds);
+    EXPECT_LT(0, prof.record(profiler_type::BLOCK).throughput());
+
+    sol->reset_profiler();
+    sol->set_block_steps(1);
+    sol->set_use_fused(true);
+    sol->march_alpha<1>(steps);
+    EXPECT_EQ(2*steps, prof.record(profiler_type::FUSED).ncall);
+    EXPECT_EQ(2*steps, prof.record(profiler_type::BOUNDARY).ncall);
+    EXPECT_EQ(steps, prof.record(profiler_type::CFL).ncall);
+    EXPECT_EQ(0, prof.record(profiler_type::SO0).ncall);
+
+}
+
+TEST(MarchTaskTest, MatchesMarch)
+{
+
+    constexpr size_t ncelm = 100;
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    std::vector<std::shared_ptr<st::LinearScalarSolver>> sols;
+    for (size_t isol=0; isol<2; ++isol)
+    {
+        std::shared_ptr<st::LinearScalarSolver> sol=st::LinearScalarSolver::construct(grid, 0.8 * 2*M_PI / ncelm);
+        for (size_t it=0; it<grid->nselm(); ++it)
+        {
+            auto se = sol->selm(it, false);
+            se.so0(0) = std::sin(se.x());
+            se.so1(0) = std::cos(se.x());
+        }
+        sol->setup_march();
+        sols.push_back(sol);
+    }
+
+    std::shared_ptr<st::MarchTask> task=st::march_alpha_async<2>(sols[0], 30, 7);
+    EXPECT_TRUE(task->wait());
+    task->get();
+    EXPECT_TRUE(task->done());
+    EXPECT_FALSE(task->cancelled());
+    EXPECT_EQ(30, task->progress());
+    EXPECT_EQ(30, sols[0]->step());
+    // The task drops the solver before it is done.
+    EXPECT_EQ(1, sols[0].use_count());
+    sols[1]->march_alpha<2>(30);
+    for (size_t it=0; it<grid->xsize(); ++it)
+    {
+        EXPECT_EQ(sols[1]->so0()(it, 0), sols[0]->so0()(it, 0));
+        EXPECT_EQ(sols[1]->so1()(it, 0), sols[0]->so1()(it, 0));
+    }
+
+}
+
+TEST(MarchTaskTest, CancelAndError)
+{
+
+    std::atomic<size_t> count{0};
+    std::shared_ptr<st::MarchTask> task=st::MarchTask::construct
+    (
+        [&count](size_t steps)
+        {
+            count += steps;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      , 1000000
+    );
+    while (0 == task->progress()) { std::this_thread::yield(); }
+    task->cancel();
+    EXPECT_TRUE(task->wait(10));
+    EXPECT_TRUE(task->cancelled());
+    EXPECT_LT(task->progress(), task->steps());
+    EXPECT_EQ(count.load(), task->progress());
+
+    task=st::MarchTask::construct([](size_t) { throw std::runtime_error("march failed"); }, 10);
+    EXPECT_THROW(task->get(), std::runtime_error);
+    EXPECT_TRUE(task->done());
+    EXPECT_EQ(0, task->progress());
+
+    EXPECT_THROW(st::MarchTask::construct([](size_t) {}, 10, 0), std::invalid_argument);
+
+    // Cancel all the running tasks at once.
+    std::vector<std::shared_ptr<st::MarchTask>> tasks;
+    for (size_t it=0; it<3; ++it)
+    {
+        tasks.push_back(st::MarchTask::construct([](size_t) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }, 1000000));
+    }
+    st::MarchTask::cancel_all();
+    for (auto const & t : tasks)
+    {
+        EXPECT_TRUE(t->done());
+        EXPECT_TRUE(t->cancelled());
+    }
+
+}
+
+TEST(MarchTaskTest, Owner)
+{
+
+    std::shared_ptr<st::LinearScalarSolver> sol=make_sine_solver<st::LinearScalarSolver>(101);
+    std::atomic<bool> busy_in_task{true};
+    std::shared_ptr<st::MarchTask> task=st::MarchTask::construct
+    (
+        [sol, &busy_in_task](size_t steps)
+        {
+            // The marching thread itself may use the solver.
+            busy_in_task = st::MarchTask::busy(sol.get());
+            sol->march_alpha<2>(steps);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      , 1000000, 1, sol.get(), &sol->grid()
+    );
+    EXPECT_TRUE(st::MarchTask::busy(sol.get()));
+    EXPECT_TRUE(st::MarchTask::busy_grid(&sol->grid()));
+    EXPECT_THROW(st::march_alpha_async<2>(sol, 10), std::runtime_error);
+    while (0 == task->progress()) { std::this_thread::yield(); }
+    EXPECT_FALSE(busy_in_task.load());
+    task->cancel();
+    task->wait();
+    // Free as soon as the task is done.
+    EXPECT_FALSE(st::MarchTask::busy(sol.get()));
+    EXPECT_FALSE(st::MarchTask::busy_grid(&sol->grid()));
+    st::march_alpha_async<2>(sol, 10)->get();
+    EXPECT_FALSE(st::MarchTask::busy(sol.get()));
+
+}
+
+TEST(SolverTest, MarchMultipleVariables)
+{
+
+    constexpr size_t ncelm = 64;
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    const double dt = 0.5 * 2*M_PI / ncelm;
+
+    std::shared_ptr<st::Solver> sol=st::Solver::construct(grid, dt, 2);
+    set_linear_scalar_kernel(sol->kernel());
+    std::shared_ptr<st::LinearScalarSolver> lsol=st::LinearScalarSolver::construct(grid, dt);
+
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        const double x = sol->selm(it, false).x();
+        sol->selm(it, false).so0(0) = std::sin(x);
+        sol->selm(it, false).so1(0) = std::cos(x);
+        sol->selm(it, false).so0(1) = 2 * std::sin(x);
+        sol->selm(it, false).so1(1) = 2 * std::cos(x);
+        lsol->selm(it, false).so0(0) = std::sin(x);
+        lsol->selm(it, false).so1(0) = std::cos(x);
+    }
+    sol->setup_march();
+    lsol->setup_march();
+
+    sol->march_alpha<2>(10);
+    lsol->march_alpha<2>(10);
+
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        const double gold = lsol->selm(it, false).so0(0);
+        EXPECT_DOUBLE_EQ(gold, sol->selm(it, false).so0(0));
+        EXPECT_DOUBLE_EQ(2 * gold, sol->selm(it, false).so0(1));
+    }
+
+}
+
+TEST(SolverTest, SetArrayMessage)
+{
+
+    std::shared_ptr<st::LinearScalarSolver> sol=st::LinearScalarSolver::construct(st::Grid::construct(0, 1, 10), 0.01);
+    using array_type = st::LinearScalarSolver::array_type;
+    const array_type good(std::vector<size_t>{sol->grid().nselm()});
+    const array_type bad(std::vector<size_t>{3});
+
+    auto message = [](std::function<void()> const & f)
+    {
+        try { f(); }
+        catch (std::out_of_range const & e) { return std::string(e.what()); }
+        return std::string();
+    };
+
+    EXPECT_EQ("set_so0(): iv 1 >= nvar 1", message([&]{ sol->set_so0(1, good, false); }));
+    EXPECT_EQ("set_so1(): iv 1 >= nvar 1", message([&]{ sol->set_so1(1, good, false); }));
+    EXPECT_EQ("set_so0(): arr size 3 != nselm 11", message([&]{ sol->set_so0(0, bad, false); }));
+    EXPECT_EQ("set_so1(): arr size 3 != nselm 10", message([&]{ sol->set_so1(0, bad, true); }));
+    EXPECT_EQ("set_cfl(): arr size 3 != nselm 11", message([&]{ sol->set_cfl(bad, false); }));
+
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+
+#include <cmath>
+#include <functional>
+
+#include "spacetime.hpp"
+#include "spacetime/Distributed.hpp"
+
+
+namespace st = spacetime;
+
+namespace
+{
+
+using init_type = std::function<void (st::Selm &)>;
+
+int mpi_rank()
+{
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return rank;
+}
+
+/**
+ * March a distributed solver and a serial solver on the same grid, and
+ * compare the gathered solution.
+ */
+template< typename ST, size_t ALPHA, typename ... Args >
+void check_distributed_march
+(
+    std::shared_ptr<st::Grid> const & grid, st::Boundary const & left, st::Boundary const & right
+  , bool use_sweep, init_type const & init, size_t steps, Args && ... args
+)
+{
+    std::shared_ptr<st::DistributedSolver<ST>> dsol=st::DistributedSolver<ST>::construct(MPI_COMM_WORLD, grid, args ...);
+    dsol->set_boundary(left, right);
+    dsol->local().set_use_sweep(use_sweep);
+    dsol->local().set_nthread(2);
+    for (size_t it=0; it<dsol->local().grid().nselm(); ++it)
+    {
+        auto se = dsol->local().selm(it, false);
+        init(se);
+    }
+    dsol->setup_march();
+    dsol->template march_alpha<ALPHA>(steps);
+    const double cfl_max = dsol->cfl_max();
+    EXPECT_EQ(steps, dsol->local().step());
+
+    std::shared_ptr<ST> sol=ST::construct(grid, args ...);
+    sol->set_left_boundary(left);
+    sol->set_right_boundary(right);
+    for (size_t it=0; it<grid->nselm(); ++it)
+    {
+        auto se = sol->selm(it, false);
+        init(se);
+    }
+    sol->setup_march();
+    sol->template march_alpha<ALPHA>(steps);
+
+    for (bool odd_plane : {false, true})
+    {
+        for (size_t iv=0; iv<sol->nvar(); ++iv)
+        {
+            const auto so0 = dsol->gather_so0(iv, odd_plane);
+            const auto so1 = dsol->gather_so1(iv, odd_plane);
+            if (0 != mpi_rank()) { continue; }
+            const auto so0_serial = sol->get_so0(iv, odd_plane);
+            const auto so1_serial = sol->get_so1(iv, odd_plane);
+            ASSERT_EQ(so0_serial.size(), so0.size());
+            for (size_t it=0; it<so0.size(); ++it)
+            {
+                EXPECT_EQ(so0_serial[it], so0[it]);
+                EXPECT_EQ(so1_serial[it], so1[it]);
+            }
+        }
+    }
+    EXPECT_EQ(sol->cfl_max(), cfl_max);
+}
+
+} /* end namespace */
+
+TEST(DistributedTest, Partition)
+{
+
+    using dsol_type = st::DistributedSolver<st::LinearScalarSolver>;
+    size_t total = 0;
+    st::sindex_type end = 0;
+    for (int rank=0; rank<4; ++rank)
+    {
+        const auto range = dsol_type::partition(10, 4, rank);
+        EXPECT_EQ(end, range.first);
+        EXPECT_LE(2, range.second - range.first);
+        EXPECT_GE(3, range.second - range.first);
+        total += range.second - range.first;
+        end = range.second;
+    }
+    EXPECT_EQ(10, total);
+
+}
+
+TEST(DistributedTest, LinearScalarPeriodic)
+{
+
+    constexpr size_t ncelm = 101;
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+    const auto init = [](st::Selm & se)
+    {
+        se.so0(0) = std::sin(se.x());
+        se.so1(0) = std::cos(se.x());
+    };
+    const double dt = 0.8 * 2*M_PI / ncelm;
+    check_distributed_march<st::LinearScalarSolver, 2>
+    (
+        grid, st::Boundary::periodic(), st::Boundary::periodic(), false, init, 40, dt
+    );
+    check_distributed_march<st::LinearScalarSolver, 0>
+    (
+        grid, st::Boundary::periodic(), st::Boundary::periodic(), true, init, 40, dt
+    );
+
+}
+
+TEST(DistributedTest, InviscidBurgersStretched)
+{
+
+    // Non-uniform grid, so that the ghost coordinates of the ranks matter.
+    constexpr size_t ncelm = 90;
+    st::Grid::array_type xloc(std::vector<size_t>{ncelm+1});
+    for (size_t it=0; it<=ncelm; ++it) { xloc[it] = std::pow(static_cast<double>(it) / ncelm, 1.5); }
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(xloc);
+    const auto init = [](st::Selm & se)
+    {
+        se.so0(0) = 1 + 0.5 * std::sin(2*M_PI*se.x());
+        se.so1(0) = M_PI * std::cos(2*M_PI*se.x());
+    };
+    check_distributed_march<st::InviscidBurgersSolver, 1>
+    (
+        grid, st::Boundary::dirichlet({1}), st::Boundary::extrapolate(), true, init, 30, 1.e-3
+    );
+
+}
+
+TEST(DistributedTest, EulerShockTube)
+{
+
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 1, 200);
+    const auto init = [](st::Selm & se)
+    {
+        const bool left = se.x() < 0.5;
+        se.so0(0) = left ? 1.0 : 0.125;
+        se.so0(1) = 0;
+        se.so0(2) = (left ? 1.0 : 0.1) / (st::EulerFlux::gamma() - 1);
+        for (size_t iv=0; iv<3; ++iv) { se.so1(iv) = 0; }
+    };
+    check_distributed_march<st::EulerSolver, 1>
+    (
+        grid, st::Boundary::extrapolate(), st::Boundary::reflect({1, -1, 1}), false, init, 100, 1.e-3
+    );
+
+    std::shared_ptr<st::DistributedSolver<st::EulerSolver>> dsol=st::DistributedSolver<st::EulerSolver>::construct(MPI_COMM_WORLD, grid, 1.e-3);
+    EXPECT_THROW(dsol->set_boundary(st::Boundary::periodic(), st::Boundary::extrapolate()), std::invalid_argument);
+
+}
+
+int main(int argc, char ** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    // Only the first rank prints.
+    if (0 != mpi_rank())
+    {
+        ::testing::TestEventListeners & listeners = ::testing::UnitTest::GetInstance()->listeners();
+        delete listeners.Release(listeners.default_result_printer());
+    }
+    const int ret = RUN_ALL_TESTS();
+    int global = 0;
+    MPI_Allreduce(&ret, &global, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Finalize();
+    return global;
+}
+
+// vim: set et sw=4 ts=4:
@@ -14,11 +14,24 @@
 #include "spacetime/Grid.hpp"
 #include "spacetime/Celm.hpp"
 #include "spacetime/Field.hpp"
+#include "spacetime/Boundary.hpp"
+#include "spacetime/Ensemble.hpp"
+#include "spacetime/SweepSolver.hpp"
+#include "spacetime/Checkpoint.hpp"
+#include "spacetime/Snapshot.hpp"
+#include "spacetime/Profile.hpp"
+#include "spacetime/MarchTask.hpp"
 #include "spacetime/SolverBase.hpp"
 #include "spacetime/Solver.hpp"
 #include "spacetime/Selm.hpp"
+#include "spacetime/PolicySolver.hpp"
 #include "spacetime/kernel/linear_scalar.hpp"
 #include "spacetime/kernel/inviscid_burgers.hpp"
+#include "spacetime/kernel/linear_scalar_ensemble.hpp"
+#include "spacetime/kernel/inviscid_burgers_ensemble.hpp"
+#include "spacetime/kernel/linear_scalar_f32.hpp"
+#include "spacetime/kernel/inviscid_burgers_f32.hpp"
+#include "spacetime/kernel/euler.hpp"
 #include "spacetime/io.hpp"
 
 /* vim: set et ts=4 sw=4: */
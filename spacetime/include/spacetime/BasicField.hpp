@@ -0,0 +1,121 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+#include <memory>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/memory.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Solution storage of value type T on a grid: the (xsize, nvar) so0 and so1
+ * and the (xsize) CFL numbers, laid out as in Field.  It holds neither a
+ * kernel nor element proxies, and is marched by SweepSolver.  The grid and
+ * the time increment stay double; the half and quarter time increments are
+ * kept in the calculation type A.
+ */
+template< typename T, typename A = T >
+class BasicField
+{
+
+public:
+
+    using value_type = T;
+    using calc_type = A;
+    using array_type = modmesh::SimpleArray<T>;
+
+    BasicField(std::shared_ptr<Grid> const & grid, real_type time_increment, size_t nvar)
+      : m_grid(grid)
+      , m_so0(array_type(std::vector<size_t>{grid->xsize(), nvar}))
+      , m_so1(array_type(std::vector<size_t>{grid->xsize(), nvar}))
+      , m_cfl(array_type(std::vector<size_t>{grid->xsize()}))
+    {
+        set_time_increment(time_increment);
+    }
+
+    BasicField() = delete;
+    BasicField(BasicField const & ) = default;
+    BasicField(BasicField       &&) = default;
+    BasicField & operator=(BasicField const & ) = default;
+    BasicField & operator=(BasicField       &&) = default;
+    ~BasicField() = default;
+
+    BasicField clone(bool grid=false) const
+    {
+        BasicField ret(*this);
+        if (grid) { ret.m_grid = m_grid->clone(); }
+        return ret;
+    }
+
+    Grid const & grid() const { return *m_grid; }
+    Grid       & grid()       { return *m_grid; }
+
+    array_type const & so0() const { return *m_so0; }
+    array_type       & so0()       { return *m_so0; }
+    array_type const & so1() const { return *m_so1; }
+    array_type       & so1()       { return *m_so1; }
+    array_type const & cfl() const { return *m_cfl; }
+    array_type       & cfl()       { return *m_cfl; }
+
+    /**
+     * Shared ownership of the arrays, as Field::shared_so0().
+     */
+    std::shared_ptr<array_type const> shared_so0() const { return m_so0.share(); }
+    std::shared_ptr<array_type      > shared_so0()       { return m_so0.share(); }
+    std::shared_ptr<array_type const> shared_so1() const { return m_so1.share(); }
+    std::shared_ptr<array_type      > shared_so1()       { return m_so1.share(); }
+    std::shared_ptr<array_type const> shared_cfl() const { return m_cfl.share(); }
+    std::shared_ptr<array_type      > shared_cfl()       { return m_cfl.share(); }
+
+    size_t nvar() const { return m_so0->shape()[1]; }
+
+    void set_time_increment(real_type time_increment)
+    {
+        m_time_increment = time_increment;
+        m_half_time_increment = static_cast<calc_type>(0.5 * time_increment);
+        m_quarter_time_increment = static_cast<calc_type>(0.25 * time_increment);
+    }
+
+    /**
+     * Reallocate so0, so1 and cfl as Field::place_memory() does.
+     */
+    void place_memory(size_t nthread, size_t align, bool huge_pages)
+    {
+        const size_t ncelm = m_grid->ncelm();
+        m_so0 = place_rows(*m_so0, ncelm, nthread, align, huge_pages);
+        m_so1 = place_rows(*m_so1, ncelm, nthread, align, huge_pages);
+        m_cfl = place_rows(*m_cfl, ncelm, nthread, align, huge_pages);
+    }
+
+    real_type time_increment() const { return m_time_increment; }
+    real_type dt() const { return m_time_increment; }
+    calc_type hdt() const { return m_half_time_increment; }
+    calc_type qdt() const { return m_quarter_time_increment; }
+
+private:
+
+    std::shared_ptr<Grid> m_grid;
+
+    SharedArray<array_type> m_so0;
+    SharedArray<array_type> m_so1;
+    SharedArray<array_type> m_cfl;
+
+    real_type m_time_increment = 0;
+    // Cached value;
+    calc_type m_half_time_increment = 0;
+    calc_type m_quarter_time_increment = 0;
+
+}; /* end class BasicField */
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,210 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/Field_decl.hpp"
+#include "spacetime/Selm_decl.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Treatment of the ghost solution element at one end of the grid.
+ *
+ * The ghost SEs are selm(-1, true) on the left and selm(ncelm, true) on the
+ * right.  After the first half step, SolverBase sets their so0 (order 0) and
+ * then so1 (order 1) from the SE next to the ghost ("inner"), or, for the
+ * periodic condition, from the SE next to the other ghost ("opposite").
+ */
+class Boundary
+{
+
+public:
+
+    using value_type = Grid::value_type;
+    /**
+     * Set the so0 (order 0) or so1 (order 1) of the ghost SE.
+     */
+    using callback_type = std::function<void (Selm & ghost, Selm const & inner, size_t order)>;
+
+    enum Type
+    {
+        PERIODIC
+      , EXTRAPOLATE
+      , REFLECT
+      , DIRICHLET
+      , CALLBACK
+    };
+
+    Boundary() = default;
+    Boundary(Boundary const & ) = default;
+    Boundary(Boundary       &&) = default;
+    Boundary & operator=(Boundary const & ) = default;
+    Boundary & operator=(Boundary       &&) = default;
+    ~Boundary() = default;
+
+    /**
+     * Copy the solution at the other end of the grid.
+     */
+    static Boundary periodic() { return Boundary(PERIODIC); }
+    /**
+     * Copy the solution next to the ghost, so that waves leave the grid
+     * without reflection.
+     */
+    static Boundary extrapolate() { return Boundary(EXTRAPOLATE); }
+    /**
+     * Mirror the solution next to the ghost.  so0 of variable iv is
+     * multiplied by signs[iv] and so1 by -signs[iv].  Empty signs mean 1 for
+     * all variables.  A velocity-like variable takes the sign -1 for a solid
+     * wall.
+     */
+    static Boundary reflect(std::vector<value_type> signs = {})
+    {
+        Boundary ret(REFLECT);
+        ret.m_values = std::move(signs);
+        return ret;
+    }
+    /**
+     * Hold so0 at the given values and so1 at zero.
+     */
+    static Boundary dirichlet(std::vector<value_type> values)
+    {
+        Boundary ret(DIRICHLET);
+        ret.m_values = std::move(values);
+        return ret;
+    }
+    static Boundary callback(callback_type cb)
+    {
+        if (!cb) { throw std::invalid_argument("Boundary::callback(): empty callback"); }
+        Boundary ret(CALLBACK);
+        ret.m_callback = std::move(cb);
+        return ret;
+    }
+
+    Type type() const { return m_type; }
+    std::vector<value_type> const & values() const { return m_values; }
+    callback_type const & get_callback() const { return m_callback; }
+
+    /**
+     * Throw std::invalid_argument if the values do not fit nvar variables.
+     */
+    void validate(size_t nvar) const
+    {
+        const bool sized = (DIRICHLET == m_type) || (REFLECT == m_type && !m_values.empty());
+        if (sized && m_values.size() != nvar)
+        {
+            throw std::invalid_argument
+            (
+                Formatter() << "Boundary: " << m_values.size() << " values != nvar " << nvar
+            );
+        }
+    }
+
+    void treat(Selm & ghost, Selm const & inner, Selm const & opposite, size_t order) const
+    {
+        const size_t nvar = ghost.field().nvar();
+        switch (m_type)
+        {
+        case PERIODIC:
+            for (size_t iv=0; iv<nvar; ++iv) { so(ghost, order, iv) = so(opposite, order, iv); }
+            break;
+        case EXTRAPOLATE:
+            for (size_t iv=0; iv<nvar; ++iv) { so(ghost, order, iv) = so(inner, order, iv); }
+            break;
+        case REFLECT:
+            for (size_t iv=0; iv<nvar; ++iv)
+            {
+                const value_type sign = m_values.empty() ? 1.0 : m_values[iv];
+                so(ghost, order, iv) = (0 == order ? sign : -sign) * so(inner, order, iv);
+            }
+            break;
+        case DIRICHLET:
+            for (size_t iv=0; iv<nvar; ++iv) { so(ghost, order, iv) = 0 == order ? m_values[iv] : 0.0; }
+            break;
+        case CALLBACK:
+            m_callback(ghost, inner, order);
+            break;
+        }
+    }
+
+    /**
+     * Treat a ghost row of the interleaved (xsize, ncol) data of the solvers
+     * not holding a Field, as treat() does for the variables of a Selm.  The
+     * columns take the condition of variable 0.  The callback condition is
+     * not supported and leaves the row alone.
+     */
+    template< typename T >
+    void treat_row(T * ghost, T const * inner, T const * opposite, size_t ncol, size_t order) const
+    {
+        switch (m_type)
+        {
+        case PERIODIC:
+            for (size_t ic=0; ic<ncol; ++ic) { ghost[ic] = opposite[ic]; }
+            break;
+        case EXTRAPOLATE:
+            for (size_t ic=0; ic<ncol; ++ic) { ghost[ic] = inner[ic]; }
+            break;
+        case REFLECT:
+        {
+            const T sign = static_cast<T>(m_values.empty() ? 1.0 : m_values[0]);
+            for (size_t ic=0; ic<ncol; ++ic) { ghost[ic] = (0 == order ? sign : -sign) * inner[ic]; }
+            break;
+        }
+        case DIRICHLET:
+            for (size_t ic=0; ic<ncol; ++ic) { ghost[ic] = static_cast<T>(0 == order ? m_values[0] : 0.0); }
+            break;
+        case CALLBACK:
+            break;
+        }
+    }
+
+private:
+
+    explicit Boundary(Type type) : m_type(type) {}
+
+    static value_type const & so(Selm const & se, size_t order, size_t iv) { return 0 == order ? se.so0(iv) : se.so1(iv); }
+    static value_type       & so(Selm       & se, size_t order, size_t iv) { return 0 == order ? se.so0(iv) : se.so1(iv); }
+
+    Type m_type = PERIODIC;
+    std::vector<value_type> m_values;
+    callback_type m_callback;
+
+}; /* end class Boundary */
+
+/**
+ * Set so0 (order 0) or so1 (order 1) of the two ghost SEs on the odd plane in
+ * the interleaved (xsize, ncol) array.
+ */
+template< typename AT >
+inline void treat_ghost_rows(Boundary const & left, Boundary const & right, AT & arr, size_t order)
+{
+    const size_t xsize = arr.shape()[0];
+    const size_t ncol = arr.size() / xsize;
+    const size_t ghost[2] = { Grid::BOUND_COUNT - 1, xsize - Grid::BOUND_COUNT };
+    const size_t inner[2] = { Grid::BOUND_COUNT + 1, xsize - Grid::BOUND_COUNT - 2 };
+    Boundary const * bnds[2] = { &left, &right };
+    for (size_t iside=0; iside<2; ++iside)
+    {
+        bnds[iside]->treat_row
+        (
+            arr.data() + ghost[iside] * ncol
+          , arr.data() + inner[iside] * ncol
+          , arr.data() + inner[1-iside] * ncol
+          , ncol, order
+        );
+    }
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,236 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Binary checkpoint of a Field.
+ *
+ * The file starts with Checkpoint::Header, followed by the coordinate array
+ * of the Grid, so0, so1 and cfl, all in the native double format.  Each array
+ * starts at an offset aligned to Checkpoint::ALIGNMENT bytes and recorded in
+ * the header, so that a memory map of the file gives the arrays without
+ * parsing.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/Field_decl.hpp"
+
+namespace spacetime
+{
+
+class Checkpoint
+{
+
+public:
+
+    using value_type = Field::value_type;
+
+    enum : uint32_t
+    {
+        VERSION = 1
+      , ALIGNMENT = 64
+      , BYTE_ORDER_MARK = 0x01020304
+    };
+
+    enum Array
+    {
+        XCOORD
+      , SO0
+      , SO1
+      , CFL
+      , NARRAY
+    };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t ncelm;
+        uint64_t nvar;
+        uint64_t xsize;
+        uint64_t step;
+        value_type time_increment;
+        uint64_t offset[NARRAY];
+    }; /* end struct Header */
+
+    static char const * magic() { return "LIBSTCKP"; }
+
+    static void write(std::string const & path, Field const & field, uint64_t step)
+    {
+        Header header{};
+        std::memcpy(header.magic, magic(), sizeof(header.magic));
+        header.version = VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.ncelm = field.grid().ncelm();
+        header.nvar = field.nvar();
+        header.xsize = field.grid().xsize();
+        header.step = step;
+        header.time_increment = field.time_increment();
+        value_type const * data[NARRAY] = {
+            field.grid().xcoord().data(), field.so0().data(), field.so1().data(), field.cfl().data()
+        };
+        uint64_t offset = sizeof(Header);
+        for (size_t it=0; it<NARRAY; ++it)
+        {
+            offset = align(offset);
+            header.offset[it] = offset;
+            offset += array_size(header, static_cast<Array>(it)) * sizeof(value_type);
+        }
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream) { throw std::runtime_error(Formatter() << "Checkpoint: cannot open " << path << " for writing"); }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+        uint64_t pos = sizeof(Header);
+        const char zeros[ALIGNMENT] = {};
+        for (size_t it=0; it<NARRAY; ++it)
+        {
+            stream.write(zeros, static_cast<std::streamsize>(header.offset[it] - pos));
+            const uint64_t nbyte = array_size(header, static_cast<Array>(it)) * sizeof(value_type);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            stream.write(reinterpret_cast<char const *>(data[it]), static_cast<std::streamsize>(nbyte));
+            pos = header.offset[it] + nbyte;
+        }
+        if (!stream) { throw std::runtime_error(Formatter() << "Checkpoint: failed to write " << path); }
+    }
+
+    /**
+     * Map the checkpoint file read-only and validate the header.
+     */
+    explicit Checkpoint(std::string const & path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { throw std::runtime_error(Formatter() << "Checkpoint: cannot open " << path); }
+        struct stat st{};
+        if (0 != ::fstat(fd, &st))
+        {
+            ::close(fd);
+            throw std::runtime_error(Formatter() << "Checkpoint: cannot stat " << path);
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size < sizeof(Header))
+        {
+            ::close(fd);
+            throw std::runtime_error(Formatter() << "Checkpoint: " << path << " is too small for the header");
+        }
+        m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (MAP_FAILED == m_data)
+        {
+            m_data = nullptr;
+            throw std::runtime_error(Formatter() << "Checkpoint: cannot map " << path);
+        }
+        try { validate(path); }
+        catch (...) { unmap(); throw; }
+    }
+
+    Checkpoint() = delete;
+    Checkpoint(Checkpoint const & ) = delete;
+    Checkpoint(Checkpoint && other) noexcept : m_data(other.m_data), m_size(other.m_size) { other.m_data = nullptr; }
+    Checkpoint & operator=(Checkpoint const & ) = delete;
+    Checkpoint & operator=(Checkpoint && other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            m_data = other.m_data;
+            m_size = other.m_size;
+            other.m_data = nullptr;
+        }
+        return *this;
+    }
+    ~Checkpoint() { unmap(); }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    Header const & header() const { return *reinterpret_cast<Header const *>(m_data); }
+    size_t size() const { return m_size; }
+
+    value_type const * array(Array which) const
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<value_type const *>(static_cast<char const *>(m_data) + header().offset[which]);
+    }
+    value_type const * xcoord() const { return array(XCOORD); }
+    value_type const * so0() const { return array(SO0); }
+    value_type const * so1() const { return array(SO1); }
+    value_type const * cfl() const { return array(CFL); }
+
+    /**
+     * Number of values in the array.
+     */
+    static uint64_t array_size(Header const & header, Array which)
+    {
+        return (SO0 == which || SO1 == which) ? header.xsize * header.nvar : header.xsize;
+    }
+
+private:
+
+    static uint64_t align(uint64_t offset) { return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+    void validate(std::string const & path) const
+    {
+        Header const & hdr = header();
+        if (0 != std::memcmp(hdr.magic, magic(), sizeof(hdr.magic)))
+        {
+            throw std::runtime_error(Formatter() << "Checkpoint: " << path << " is not a checkpoint");
+        }
+        if (BYTE_ORDER_MARK != hdr.byte_order)
+        {
+            throw std::runtime_error(Formatter() << "Checkpoint: " << path << " has a different byte order");
+        }
+        if (VERSION != hdr.version)
+        {
+            throw std::runtime_error
+            (
+                Formatter() << "Checkpoint: " << path << " version " << hdr.version
+                            << " != " << static_cast<uint32_t>(VERSION)
+            );
+        }
+        if (hdr.xsize != 2*hdr.ncelm + 1 + 2*Grid::BOUND_COUNT)
+        {
+            throw std::runtime_error
+            (
+                Formatter() << "Checkpoint: " << path << " xsize " << hdr.xsize << " != ncelm " << hdr.ncelm
+            );
+        }
+        for (size_t it=0; it<NARRAY; ++it)
+        {
+            const uint64_t end = hdr.offset[it] + array_size(hdr, static_cast<Array>(it)) * sizeof(value_type);
+            if (hdr.offset[it] % sizeof(value_type) || hdr.offset[it] < sizeof(Header) || end > m_size)
+            {
+                throw std::runtime_error(Formatter() << "Checkpoint: " << path << " is truncated or corrupted");
+            }
+        }
+    }
+
+    void unmap()
+    {
+        if (m_data) { ::munmap(m_data, m_size); }
+        m_data = nullptr;
+    }
+
+    void * m_data = nullptr;
+    size_t m_size = 0;
+
+}; /* end class Checkpoint */
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,349 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Domain decomposition of a solver over MPI ranks.
+ *
+ * The CEs of the global grid are split into contiguous ranges, one for each
+ * rank.  A rank marches its range with a local solver, whose grid takes the
+ * coordinates of the global grid including the ghost ones, so that the local
+ * arithmetic is the same as that of a single solver on the global grid.
+ *
+ * The only values a rank needs from its neighbors are the two SEs next to
+ * its range on the odd plane after the first half step, which are the ghost
+ * SEs of the local solver.  They are exchanged with non-blocking messages
+ * while the interior CEs are marched, and set by callback boundaries of the
+ * local solver.  The SEs at the ends of the ranges on the even plane are
+ * calculated by both neighboring ranks from the same values.
+ *
+ * The header is not included by spacetime.hpp, because it needs MPI.
+ */
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid.hpp"
+#include "spacetime/Boundary.hpp"
+#include "spacetime/SolverBase.hpp"
+#include "spacetime/parallel.hpp"
+
+namespace spacetime
+{
+
+template< typename ST >
+class DistributedSolver
+{
+
+private:
+
+    class ctor_passkey {};
+
+public:
+
+    using solver_type = ST;
+    using value_type = typename ST::value_type;
+    using array_type = typename ST::array_type;
+    static_assert(std::is_same<value_type, double>::value, "the messages are of MPI_DOUBLE");
+
+    /**
+     * Split the grid over the ranks of comm and construct the local solver
+     * by ST::construct(local_grid, args...).  It is collective over comm.
+     */
+    template< typename ... Args >
+    static std::shared_ptr<DistributedSolver>
+    construct(MPI_Comm comm, std::shared_ptr<Grid> const & grid, Args && ... args)
+    {
+        return std::make_shared<DistributedSolver>(comm, grid, ctor_passkey(), std::forward<Args>(args) ...);
+    }
+
+    template< typename ... Args >
+    DistributedSolver(MPI_Comm comm, std::shared_ptr<Grid> const & grid, ctor_passkey const &, Args && ... args)
+      : m_grid(grid)
+    {
+        MPI_Comm_dup(comm, &m_comm);
+        MPI_Comm_rank(m_comm, &m_rank);
+        MPI_Comm_size(m_comm, &m_size);
+        // Checked before partitioning, so that every rank of the same global
+        // grid throws, and none is left waiting in a collective call.
+        if (grid->ncelm() < static_cast<size_t>(m_size))
+        {
+            MPI_Comm_free(&m_comm);
+            throw std::invalid_argument
+            (
+                Formatter() << "DistributedSolver: ncelm " << grid->ncelm() << " < number of ranks " << m_size
+            );
+        }
+        const std::pair<sindex_type, sindex_type> range = partition(grid->ncelm(), m_size, m_rank);
+        m_begin = range.first;
+        m_end = range.second;
+        // The local grid takes the global coordinates, including the ghost
+        // ones from the neighboring ranges.
+        const size_t ncelm = m_end - m_begin;
+        Grid::array_type xloc(std::vector<size_t>{ncelm + 1});
+        Grid::array_type const & gcrd = grid->xcoord();
+        for (size_t it=0; it<=ncelm; ++it) { xloc[it] = gcrd[Grid::BOUND_COUNT + 2*(m_begin + it)]; }
+        std::shared_ptr<Grid> local_grid = Grid::construct(xloc);
+        Grid::array_type & lcrd = local_grid->xcoord();
+        for (size_t it=0; it<local_grid->xsize(); ++it) { lcrd[it] = gcrd[2*m_begin + it]; }
+        if (grid->has_geometry()) { local_grid->build_geometry(); }
+        m_local = ST::construct(local_grid, std::forward<Args>(args) ...);
+        m_nvar = m_local->nvar();
+        for (auto & buf : m_send) { buf.resize(2 * m_nvar); }
+        for (auto & buf : m_recv) { buf = std::make_shared<std::vector<value_type>>(2 * m_nvar); }
+        set_boundary(Boundary::periodic(), Boundary::periodic());
+    }
+
+    DistributedSolver() = delete;
+    DistributedSolver(DistributedSolver const & ) = delete;
+    DistributedSolver(DistributedSolver       &&) = delete;
+    DistributedSolver & operator=(DistributedSolver const & ) = delete;
+    DistributedSolver & operator=(DistributedSolver       &&) = delete;
+    ~DistributedSolver() { MPI_Comm_free(&m_comm); }
+
+    /**
+     * Range [begin, end) of the CEs on the even plane of the rank among
+     * nrank ranks.  The ranges differ in size by at most one.
+     */
+    static std::pair<sindex_type, sindex_type> partition(size_t ncelm, int nrank, int rank)
+    {
+        const size_t base = ncelm / nrank;
+        const size_t rem = ncelm % nrank;
+        const size_t urank = rank;
+        const size_t begin = urank * base + std::min(urank, rem);
+        const size_t end = begin + base + (urank < rem ? 1 : 0);
+        return { static_cast<sindex_type>(begin), static_cast<sindex_type>(end) };
+    }
+
+    MPI_Comm comm() const { return m_comm; }
+    int rank() const { return m_rank; }
+    int nrank() const { return m_size; }
+
+    /**
+     * Global grid.
+     */
+    Grid const & grid() const { return *m_grid; }
+    /**
+     * Solver of the CEs [begin(), end()) of the global grid.  CE ic and SE
+     * is of the local solver are CE begin()+ic and SE begin()+is of the
+     * global grid on the same plane.
+     */
+    ST const & local() const { return *m_local; }
+    ST       & local()       { return *m_local; }
+    sindex_type begin() const { return m_begin; }
+    sindex_type end() const { return m_end; }
+
+    /**
+     * Boundary conditions at the two ends of the global grid.  Periodic must
+     * be set on both ends or on neither.
+     */
+    Boundary const & left_boundary() const { return m_left_boundary; }
+    Boundary const & right_boundary() const { return m_right_boundary; }
+    void set_boundary(Boundary const & left, Boundary const & right)
+    {
+        const bool periodic = Boundary::PERIODIC == left.type();
+        if (periodic != (Boundary::PERIODIC == right.type()))
+        {
+            throw std::invalid_argument("DistributedSolver: periodic must be set on both ends or on neither");
+        }
+        left.validate(m_nvar);
+        right.validate(m_nvar);
+        m_left_boundary = left;
+        m_right_boundary = right;
+        const bool first = 0 == m_rank;
+        const bool last = m_size - 1 == m_rank;
+        m_left = (first && !periodic) ? MPI_PROC_NULL : (m_rank + m_size - 1) % m_size;
+        m_right = (last && !periodic) ? MPI_PROC_NULL : (m_rank + 1) % m_size;
+        m_local->set_left_boundary(MPI_PROC_NULL == m_left ? left : halo_boundary(m_recv[0]));
+        m_local->set_right_boundary(MPI_PROC_NULL == m_right ? right : halo_boundary(m_recv[1]));
+    }
+
+    void setup_march() { m_local->setup_march(); }
+
+    /**
+     * Maximum CFL number over all ranks of the last update.  It is
+     * collective.
+     */
+    value_type cfl_max() const
+    {
+        value_type local = m_local->cfl_max();
+        value_type ret = 0;
+        MPI_Allreduce(&local, &ret, 1, MPI_DOUBLE, MPI_MAX, m_comm);
+        return ret;
+    }
+
+    template <size_t ALPHA> void march_alpha(size_t steps);
+
+    /**
+     * Gather variable iv of the SEs on the plane of all ranks to root, in
+     * the order of the global grid.  Other ranks get an empty array.  It is
+     * collective.
+     */
+    array_type gather_so0(size_t iv, bool odd_plane, int root=0) const
+    {
+        return gather(m_local->so0(), iv, m_nvar, odd_plane, root);
+    }
+    array_type gather_so1(size_t iv, bool odd_plane, int root=0) const
+    {
+        return gather(m_local->so1(), iv, m_nvar, odd_plane, root);
+    }
+    array_type gather_cfl(bool odd_plane, int root=0) const
+    {
+        return gather(m_local->cfl(), 0, 1, odd_plane, root);
+    }
+
+private:
+
+    /**
+     * Boundary setting the ghost SE from the values received from the
+     * neighbor, so0 of all variables followed by so1.
+     */
+    static Boundary halo_boundary(std::shared_ptr<std::vector<value_type>> const & halo)
+    {
+        return Boundary::callback([halo](Selm & ghost, Selm const & /*inner*/, size_t order)
+        {
+            const size_t nvar = ghost.field().nvar();
+            value_type const * src = halo->data() + order * nvar;
+            for (size_t iv=0; iv<nvar; ++iv)
+            {
+                if (0 == order) { ghost.so0(iv) = src[iv]; }
+                else            { ghost.so1(iv) = src[iv]; }
+            }
+        });
+    }
+
+    template <size_t ALPHA> void march_half1_alpha();
+    array_type gather(array_type const & arr, size_t iv, size_t ncol, bool odd_plane, int root) const;
+
+    enum { TAG_LEFTWARD = 1, TAG_RIGHTWARD = 2 };
+
+    MPI_Comm m_comm = MPI_COMM_NULL;
+    int m_rank = 0;
+    int m_size = 1;
+    std::shared_ptr<Grid> m_grid;
+    sindex_type m_begin = 0;
+    sindex_type m_end = 0;
+    std::shared_ptr<ST> m_local;
+    size_t m_nvar = 0;
+    Boundary m_left_boundary;
+    Boundary m_right_boundary;
+    int m_left = MPI_PROC_NULL;
+    int m_right = MPI_PROC_NULL;
+    // Halo SEs to and from the left ([0]) and right ([1]) neighbors.
+    std::vector<value_type> m_send[2];
+    std::shared_ptr<std::vector<value_type>> m_recv[2];
+
+}; /* end class DistributedSolver */
+
+/**
+ * First half step of the local solver.  The CEs at the two ends of the range
+ * are marched first, and their top SEs are sent to the neighbors while the
+ * interior CEs are marched.  The received SEs become the ghost SEs.
+ */
+template< typename ST >
+template< size_t ALPHA >
+inline void DistributedSolver<ST>::march_half1_alpha()
+{
+    ST & sol = *m_local;
+    const sindex_type ncelm = sol.grid().ncelm();
+    sol.template march_fused_range<ALPHA>(false, 0, 1, false);
+    if (ncelm > 1) { sol.template march_fused_range<ALPHA>(false, ncelm-1, ncelm, false); }
+
+    // The top SE of CE ic on the even plane is SE ic on the odd plane.
+    const size_t nvar = m_nvar;
+    const sindex_type edge[2] = { 0, ncelm-1 };
+    for (size_t iside=0; iside<2; ++iside)
+    {
+        const size_t xindex = ST::plane_xindex(true) + 2 * edge[iside];
+        std::copy_n(sol.so0().data() + xindex * nvar, nvar, m_send[iside].data());
+        std::copy_n(sol.so1().data() + xindex * nvar, nvar, m_send[iside].data() + nvar);
+    }
+    const int count = static_cast<int>(2 * nvar);
+    MPI_Request requests[4];
+    MPI_Irecv(m_recv[0]->data(), count, MPI_DOUBLE, m_left, TAG_RIGHTWARD, m_comm, &requests[0]);
+    MPI_Irecv(m_recv[1]->data(), count, MPI_DOUBLE, m_right, TAG_LEFTWARD, m_comm, &requests[1]);
+    MPI_Isend(m_send[0].data(), count, MPI_DOUBLE, m_left, TAG_LEFTWARD, m_comm, &requests[2]);
+    MPI_Isend(m_send[1].data(), count, MPI_DOUBLE, m_right, TAG_RIGHTWARD, m_comm, &requests[3]);
+
+    if (ncelm > 2)
+    {
+        parallel_for_chunk(1, ncelm-1, sol.nthread(), sol.celm_align(), [&sol](sindex_type begin, sindex_type end)
+        {
+            sol.template march_fused_range<ALPHA>(false, begin, end, false);
+        });
+    }
+
+    MPI_Waitall(4, requests, MPI_STATUSES_IGNORE);
+    sol.treat_boundary_so0();
+    sol.treat_boundary_so1();
+    sol.update_ghost_cfl();
+    sol.m_cfl_max = sol.reduce_cfl_max(true, -1, sol.grid().nselm());
+}
+
+template< typename ST >
+template< size_t ALPHA >
+inline void DistributedSolver<ST>::march_alpha(size_t steps)
+{
+    if (m_local->kernel().has_plane_hook())
+    {
+        throw std::runtime_error("DistributedSolver: plane hooks of Kernel are not supported");
+    }
+    for (size_t it=0; it<steps; ++it)
+    {
+        march_half1_alpha<ALPHA>();
+        m_local->template march_half_fused_alpha<ALPHA>(true);
+    }
+    m_local->m_step += steps;
+}
+
+template< typename ST >
+inline typename DistributedSolver<ST>::array_type
+DistributedSolver<ST>::gather(array_type const & arr, size_t iv, size_t ncol, bool odd_plane, int root) const
+{
+    // MPI counts and displacements are int.
+    if (grid().nselm() > static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        throw std::overflow_error(Formatter() << "DistributedSolver::gather(): nselm " << grid().nselm() << " overflows int");
+    }
+    // The SE at the right end of a range on the even plane is the first SE of
+    // the next range, and only the last rank sends it.
+    const bool last = m_size - 1 == m_rank;
+    const int count = static_cast<int>(m_end - m_begin) + ((!odd_plane && last) ? 1 : 0);
+    std::vector<value_type> sendbuf(count);
+    const size_t xbegin = ST::plane_xindex(odd_plane);
+    for (int it=0; it<count; ++it) { sendbuf[it] = arr.data()[(xbegin + 2*it) * ncol + iv]; }
+
+    std::vector<int> counts;
+    std::vector<int> displs;
+    if (root == m_rank)
+    {
+        counts.resize(m_size);
+        displs.resize(m_size);
+        for (int irank=0; irank<m_size; ++irank)
+        {
+            const std::pair<sindex_type, sindex_type> range = partition(grid().ncelm(), m_size, irank);
+            counts[irank] = static_cast<int>(range.second - range.first) + ((!odd_plane && m_size-1 == irank) ? 1 : 0);
+            displs[irank] = static_cast<int>(range.first);
+        }
+    }
+    const size_t nselm = root == m_rank ? grid().nselm() - (odd_plane ? 1 : 0) : 0;
+    array_type ret(std::vector<size_t>{nselm});
+    MPI_Gatherv(sendbuf.data(), count, MPI_DOUBLE, ret.data(), counts.data(), displs.data(), MPI_DOUBLE, root, m_comm);
+    return ret;
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,352 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Ensemble of independent scalar problems on one grid.
+ *
+ * The members share the coordinates and are stored interleaved in (xsize,
+ * nmember) arrays, so that the solutions of all members at a coordinate are
+ * contiguous.  A half step loops over the CEs and, for each CE, over the
+ * members in the innermost loop, which vectorizes across the members.  The
+ * arithmetic is ScalarSweep's, and a member marches to the same solution as
+ * a solver of its own.
+ *
+ * The solution may be stored in float (T) to halve the memory traffic and
+ * double the number of members per vector instruction.  The arithmetic is
+ * done in A, which defaults to T.  With T float and A double, the members
+ * are stored in float but calculated in double, so that the truncation of
+ * the storage is the only additional error.  The grid and the time
+ * increments given to the ensemble stay double.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/Boundary.hpp"
+#include "spacetime/parallel.hpp"
+#include "spacetime/memory.hpp"
+#include "spacetime/Sweep.hpp"
+
+namespace spacetime
+{
+
+template< typename FT, typename T = Grid::value_type, typename A = T >
+class EnsembleSolver
+  : public std::enable_shared_from_this<EnsembleSolver<FT, T, A>>
+{
+
+private:
+
+    class ctor_passkey {};
+
+public:
+
+    using value_type = T;
+    using calc_type = A;
+    using array_type = modmesh::SimpleArray<T>;
+    using flux_type = FT;
+    using sweep_type = ScalarSweep<FT>;
+
+    static std::shared_ptr<EnsembleSolver>
+    construct(std::shared_ptr<Grid> const & grid, size_t nmember, real_type time_increment)
+    {
+        return std::make_shared<EnsembleSolver>(grid, nmember, time_increment, ctor_passkey());
+    }
+
+    EnsembleSolver(std::shared_ptr<Grid> const & grid, size_t nmember, real_type time_increment, ctor_passkey const &)
+      : m_grid(grid)
+      , m_nmember(nmember)
+      , m_so0(array_type(std::vector<size_t>{grid->xsize(), nmember}))
+      , m_so1(array_type(std::vector<size_t>{grid->xsize(), nmember}))
+      , m_cfl(array_type(std::vector<size_t>{grid->xsize(), nmember}))
+      , m_time_increment(nmember)
+      , m_hdt(nmember)
+      , m_qdt(nmember)
+    {
+        if (nmember < 1)
+        {
+            throw std::invalid_argument("EnsembleSolver: nmember smaller than 1");
+        }
+        set_time_increment(time_increment);
+    }
+
+    EnsembleSolver() = delete;
+    EnsembleSolver(EnsembleSolver const & ) = default;
+    EnsembleSolver(EnsembleSolver       &&) = default;
+    EnsembleSolver & operator=(EnsembleSolver const & ) = default;
+    EnsembleSolver & operator=(EnsembleSolver       &&) = default;
+    ~EnsembleSolver() = default;
+
+    Grid const & grid() const { return *m_grid; }
+    size_t nmember() const { return m_nmember; }
+
+    /**
+     * (xsize, nmember) arrays of so0, so1 and the CFL numbers.
+     */
+    array_type const & so0() const { return *m_so0; }
+    array_type       & so0()       { return *m_so0; }
+    array_type const & so1() const { return *m_so1; }
+    array_type       & so1()       { return *m_so1; }
+    array_type const & cfl() const { return *m_cfl; }
+    array_type       & cfl()       { return *m_cfl; }
+
+    /**
+     * Shared ownership of the arrays, as Field::shared_so0().
+     */
+    std::shared_ptr<array_type const> shared_so0() const { return m_so0.share(); }
+    std::shared_ptr<array_type      > shared_so0()       { return m_so0.share(); }
+    std::shared_ptr<array_type const> shared_so1() const { return m_so1.share(); }
+    std::shared_ptr<array_type      > shared_so1()       { return m_so1.share(); }
+    std::shared_ptr<array_type const> shared_cfl() const { return m_cfl.share(); }
+    std::shared_ptr<array_type      > shared_cfl()       { return m_cfl.share(); }
+
+    /**
+     * Get and set the solution of a member on the SEs of the plane, as
+     * SolverBase::get_so0() and SolverBase::set_so0() do for a variable.
+     */
+    array_type get_so0(size_t member, bool odd_plane) const { return get_plane(*m_so0, member, odd_plane); }
+    array_type get_so1(size_t member, bool odd_plane) const { return get_plane(*m_so1, member, odd_plane); }
+    array_type get_cfl(size_t member, bool odd_plane) const { return get_plane(*m_cfl, member, odd_plane); }
+    void set_so0(size_t member, array_type const & arr, bool odd_plane) { set_plane(*m_so0, member, arr, odd_plane); }
+    void set_so1(size_t member, array_type const & arr, bool odd_plane) { set_plane(*m_so1, member, arr, odd_plane); }
+
+    /**
+     * Time increment of each member.
+     */
+    real_type time_increment(size_t member) const { return m_time_increment.at(member); }
+    void set_time_increment(size_t member, real_type time_increment)
+    {
+        check_member(member, "set_time_increment()");
+        m_time_increment[member] = time_increment;
+        m_hdt[member] = static_cast<calc_type>(0.5 * time_increment);
+        m_qdt[member] = static_cast<calc_type>(0.25 * time_increment);
+    }
+    void set_time_increment(real_type time_increment)
+    {
+        for (size_t im=0; im<m_nmember; ++im) { set_time_increment(im, time_increment); }
+    }
+
+    /**
+     * Boundary conditions shared by all members.  The callback condition is
+     * not supported, because the members are not held in Field.
+     */
+    Boundary const & left_boundary() const { return m_left_boundary; }
+    Boundary const & right_boundary() const { return m_right_boundary; }
+    void set_left_boundary(Boundary const & bnd) { validate(bnd); m_left_boundary = bnd; }
+    void set_right_boundary(Boundary const & bnd) { validate(bnd); m_right_boundary = bnd; }
+
+    size_t nthread() const { return m_nthread; }
+    void set_nthread(size_t nthread) { m_nthread = std::max(size_t(1), nthread); }
+
+    /**
+     * Reallocate so0, so1 and the CFL numbers as SolverBase::place_memory()
+     * does.  The grid is left to its solvers.
+     */
+    void place_memory(bool huge_pages=true)
+    {
+        const size_t ncelm = grid().ncelm();
+        const size_t align = cache_line_align(2 * m_nmember * sizeof(value_type));
+        m_so0 = place_rows(*m_so0, ncelm, m_nthread, align, huge_pages);
+        m_so1 = place_rows(*m_so1, ncelm, m_nthread, align, huge_pages);
+        m_cfl = place_rows(*m_cfl, ncelm, m_nthread, align, huge_pages);
+    }
+
+    size_t step() const { return m_step; }
+    void set_step(size_t step) { m_step = step; }
+
+    /**
+     * Maximum CFL number of the member over the SEs on the even plane.
+     */
+    value_type cfl_max(size_t member) const
+    {
+        check_member(member, "cfl_max()");
+        value_type ret = 0;
+        for (size_t is=0; is<grid().nselm(); ++is)
+        {
+            const value_type cfl = (*m_cfl)(Grid::BOUND_COUNT + (is << 1), member);
+            // NaN propagates.
+            ret = (ret >= cfl || std::isnan(ret)) ? ret : cfl;
+        }
+        return ret;
+    }
+
+    void update_cfl(bool odd_plane);
+    void setup_march() { update_cfl(false); }
+    template <size_t ALPHA> void march_half_alpha(bool odd_plane);
+    template <size_t ALPHA> void march_alpha(size_t steps);
+
+private:
+
+    void check_member(size_t member, char const * name) const
+    {
+        if (member >= m_nmember)
+        {
+            throw std::out_of_range(Formatter() << name << ": member " << member << " >= nmember " << m_nmember);
+        }
+    }
+
+    static void validate(Boundary const & bnd)
+    {
+        if (Boundary::CALLBACK == bnd.type())
+        {
+            throw std::invalid_argument("EnsembleSolver: callback boundary is not supported");
+        }
+        bnd.validate(1);
+    }
+
+    array_type get_plane(array_type const & arr, size_t member, bool odd_plane) const;
+    void set_plane(array_type & arr, size_t member, array_type const & src, bool odd_plane);
+    void update_ghost_cfl();
+
+    std::shared_ptr<Grid> m_grid;
+    size_t m_nmember;
+    SharedArray<array_type> m_so0;
+    SharedArray<array_type> m_so1;
+    SharedArray<array_type> m_cfl;
+    std::vector<real_type> m_time_increment;
+    std::vector<calc_type> m_hdt;
+    std::vector<calc_type> m_qdt;
+    Boundary m_left_boundary;
+    Boundary m_right_boundary;
+    size_t m_nthread = 1;
+    size_t m_step = 0;
+
+}; /* end class EnsembleSolver */
+
+template< typename FT, typename T, typename A >
+inline typename EnsembleSolver<FT, T, A>::array_type
+EnsembleSolver<FT, T, A>::get_plane(array_type const & arr, size_t member, bool odd_plane) const
+{
+    check_member(member, "get_plane()");
+    const size_t nselm = grid().nselm() - (odd_plane ? 1 : 0);
+    const size_t xbegin = Grid::BOUND_COUNT + (odd_plane ? 1 : 0);
+    array_type ret(std::vector<size_t>{nselm});
+    for (size_t it=0; it<nselm; ++it) { ret[it] = arr(xbegin + (it << 1), member); }
+    return ret;
+}
+
+template< typename FT, typename T, typename A >
+inline void EnsembleSolver<FT, T, A>::set_plane(array_type & arr, size_t member, array_type const & src, bool odd_plane)
+{
+    check_member(member, "set_plane()");
+    const size_t nselm = grid().nselm() - (odd_plane ? 1 : 0);
+    if (1 != src.shape().size() || nselm != src.size())
+    {
+        throw std::out_of_range(Formatter() << "set_plane(): input is not 1D of size " << nselm);
+    }
+    const size_t xbegin = Grid::BOUND_COUNT + (odd_plane ? 1 : 0);
+    for (size_t it=0; it<nselm; ++it) { arr(xbegin + (it << 1), member) = src[it]; }
+}
+
+template< typename FT, typename T, typename A >
+inline void EnsembleSolver<FT, T, A>::update_ghost_cfl()
+{
+    const size_t nmember = m_nmember;
+    value_type const * u = m_so0->data();
+    value_type * cfl = m_cfl->data();
+    calc_type const * hdt = m_hdt.data();
+    const size_t ghost[2] = { Grid::BOUND_COUNT - 1, grid().xsize() - Grid::BOUND_COUNT };
+    with_geometry(grid(), [&](auto const & geom)
+    {
+        for (size_t is : ghost)
+        {
+            value_type * cflrow = cfl + is * nmember;
+            for (size_t im=0; im<nmember; ++im) { cflrow[im] = sweep_type::calc_cfl(geom, u + im, hdt[im], is, nmember); }
+        }
+    });
+}
+
+template< typename FT, typename T, typename A >
+inline void EnsembleSolver<FT, T, A>::update_cfl(bool odd_plane)
+{
+    const size_t nmember = m_nmember;
+    const sindex_type start = odd_plane ? -1 : 0;
+    const sindex_type stop = grid().nselm();
+    parallel_for_chunk(start, stop, m_nthread, cache_line_align(2 * nmember * sizeof(value_type)), [this, odd_plane, nmember](sindex_type begin, sindex_type end)
+    {
+        value_type const * u = m_so0->data();
+        value_type * cfl = m_cfl->data();
+        calc_type const * hdt = m_hdt.data();
+        with_geometry(grid(), [=](auto const & geom)
+        {
+            for (sindex_type it=begin; it<end; ++it)
+            {
+                const size_t is = sweep_type::xindex_selm(it, odd_plane);
+                value_type * cflrow = cfl + is * nmember;
+                SPACETIME_PRAGMA_SIMD
+                for (size_t im=0; im<nmember; ++im) { cflrow[im] = sweep_type::calc_cfl(geom, u + im, hdt[im], is, nmember); }
+            }
+        });
+    });
+}
+
+/**
+ * Calculate so0, CFL and so1 of the top SEs of the CEs on the plane for all
+ * members in one pass, as ScalarSweep::march_fused_alpha() does for one
+ * problem.  The boundary is treated after the first half step.
+ */
+template< typename FT, typename T, typename A >
+template< size_t ALPHA >
+inline void EnsembleSolver<FT, T, A>::march_half_alpha(bool odd_plane)
+{
+    const size_t nmember = m_nmember;
+    const sindex_type start = odd_plane ? -1 : 0;
+    const sindex_type stop = grid().ncelm();
+    parallel_for_chunk(start, stop, m_nthread, cache_line_align(2 * nmember * sizeof(value_type)), [this, odd_plane, nmember](sindex_type begin, sindex_type end)
+    {
+        value_type * u = m_so0->data();
+        value_type * ux = m_so1->data();
+        value_type * cfl = m_cfl->data();
+        calc_type const * hdt = m_hdt.data();
+        calc_type const * qdt = m_qdt.data();
+        with_geometry(grid(), [=](auto const & geom)
+        {
+            for (sindex_type it=begin; it<end; ++it)
+            {
+                const size_t ic = sweep_type::xindex_celm(it, odd_plane);
+                value_type * urow = u + ic * nmember;
+                value_type * uxrow = ux + ic * nmember;
+                value_type * cflrow = cfl + ic * nmember;
+                SPACETIME_PRAGMA_SIMD
+                for (size_t im=0; im<nmember; ++im)
+                {
+                    urow[im] = sweep_type::calc_so0(geom, u + im, ux + im, hdt[im], qdt[im], ic, nmember);
+                    cflrow[im] = sweep_type::calc_cfl(geom, u + im, hdt[im], ic, nmember);
+                    uxrow[im] = sweep_type::template calc_so1_alpha<ALPHA>(geom, u + im, ux + im, hdt[im], ic, nmember);
+                }
+            }
+        });
+    });
+    if (!odd_plane)
+    {
+        treat_ghost_rows(m_left_boundary, m_right_boundary, *m_so0, 0);
+        treat_ghost_rows(m_left_boundary, m_right_boundary, *m_so1, 1);
+        update_ghost_cfl();
+    }
+}
+
+template< typename FT, typename T, typename A >
+template< size_t ALPHA >
+inline void EnsembleSolver<FT, T, A>::march_alpha(size_t steps)
+{
+    for (size_t it=0; it<steps; ++it)
+    {
+        march_half_alpha<ALPHA>(false);
+        march_half_alpha<ALPHA>(true);
+    }
+    m_step += steps;
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -8,6 +8,7 @@
 #include "spacetime/Field_decl.hpp"
 #include "spacetime/Celm_decl.hpp"
 #include "spacetime/Selm_decl.hpp"
+#include "spacetime/memory.hpp"
 
 namespace spacetime
 {
@@ -22,12 +23,93 @@ Field::Field(std::shared_ptr<Grid> const & grid, Field::value_type time_incremen
     set_time_increment(time_increment);
 }
 
+inline
+void Field::reset_grid(std::shared_ptr<Grid> const & grid)
+{
+    const size_t nvar = this->nvar();
+    m_grid = grid;
+    m_so0 = array_type(std::vector<size_t>{grid->xsize(), nvar});
+    m_so1 = array_type(std::vector<size_t>{grid->xsize(), nvar});
+    m_cfl = array_type(std::vector<size_t>{grid->xsize()});
+    m_kernel.drop_plane();
+}
+
 inline
 void Field::set_time_increment(value_type time_increment)
 {
     m_time_increment = time_increment;
     m_half_time_increment = 0.5 * time_increment;
     m_quarter_time_increment = 0.25 * time_increment;
+    m_kernel.drop_plane();
+}
+
+inline
+void Field::place_memory(size_t nthread, size_t align, bool huge_pages)
+{
+    const size_t ncelm = m_grid->ncelm();
+    m_so0 = place_rows(*m_so0, ncelm, nthread, align, huge_pages);
+    m_so1 = place_rows(*m_so1, ncelm, nthread, align, huge_pages);
+    m_cfl = place_rows(*m_cfl, ncelm, nthread, align, huge_pages);
+}
+
+inline
+Kernel::array_type Kernel::eval_plane(calc_plane_type1 const & calc, Field const & field, bool odd_plane)
+{
+    array_type ret(std::vector<size_t>{field.grid().xsize(), field.nvar()});
+    calc(field, odd_plane, ret);
+    return ret;
+}
+
+inline
+void Kernel::calc_plane(calc_plane_type1 const & calc, Field const & field, bool odd_plane, PlaneResult & ret)
+{
+    if (!calc) { return; }
+    const size_t xsize = field.grid().xsize();
+    const size_t nvar = field.nvar();
+    if (2 != ret.values.shape().size() || xsize != ret.values.shape()[0] || nvar != ret.values.shape()[1])
+    {
+        ret.values = array_type(std::vector<size_t>{xsize, nvar});
+    }
+    // Invalid until the hook returns, in case it throws.
+    ret.valid = false;
+    calc(field, odd_plane, ret.values);
+    ret.odd_plane = odd_plane;
+    ret.field = &field;
+    ret.grid = &field.grid();
+    ret.valid = true;
+}
+
+inline
+void Kernel::calc_plane_flux(Field const & field, bool odd_plane)
+{
+    calc_plane(m_xn_plane_calc, field, odd_plane, m_xn_plane);
+    calc_plane(m_xp_plane_calc, field, odd_plane, m_xp_plane);
+    calc_plane(m_tn_plane_calc, field, odd_plane, m_tn_plane);
+    calc_plane(m_tp_plane_calc, field, odd_plane, m_tp_plane);
+}
+
+inline
+void Kernel::calc_plane_so0p(Field const & field, bool odd_plane)
+{
+    calc_plane(m_so0p_plane_calc, field, odd_plane, m_so0p_plane);
+}
+
+inline
+void Kernel::drop_plane() const
+{
+    m_xn_plane.valid = false;
+    m_xp_plane.valid = false;
+    m_tn_plane.valid = false;
+    m_tp_plane.valid = false;
+    m_so0p_plane.valid = false;
+}
+
+inline
+bool Kernel::update_plane_cfl(Field & field, bool odd_plane)
+{
+    if (!m_cfl_plane_updater) { return false; }
+    m_cfl_plane_updater(field, odd_plane);
+    return true;
 }
 
 template< typename CE >
@@ -12,16 +12,26 @@
 #include "spacetime/system.hpp"
 #include "spacetime/type.hpp"
 #include "spacetime/Grid_decl.hpp"
+#include "spacetime/memory.hpp"
 
 namespace spacetime
 {
 
 class Celm;
 class Selm;
+class Field;
 
 /**
  * Calculation kernel for the physical problem to be solved.  The kernel
  * defines how the solution elements calculate fluxes and other values.
+ *
+ * Besides the per-element hooks, a kernel may take plane hooks, which
+ * calculate a value for all solution elements on a plane in one call.  A
+ * plane hook, when set, is invoked once per half step and takes precedence
+ * over the corresponding per-element hook.  Its result is only used in that
+ * half step.  Outside a half step, the first call evaluates the plane hook
+ * and keeps the result for the following calls on the same plane and grid,
+ * until drop_plane().
  */
 class Kernel
 {
@@ -29,9 +39,29 @@ class Kernel
 public:
 
     using value_type = Grid::value_type;
+    using array_type = Grid::array_type;
 
     using calc_type1 = std::function<value_type(Selm const &, size_t)>;
     using calc_type2 = std::function<void (Selm &)>;
+    /**
+     * Fill the rows of the (xsize, nvar) result array at the coordinate
+     * indices of the solution elements on the plane.
+     */
+    using calc_plane_type1 = std::function<void (Field const &, bool, array_type &)>;
+    /**
+     * Update the CFL numbers of the solution elements on the plane.
+     */
+    using calc_plane_type2 = std::function<void (Field &, bool)>;
+
+    /**
+     * Coordinate index of the first solution element used on a plane in a
+     * half step.  The following ones are every two coordinates.
+     */
+    static size_t plane_xbegin(bool odd_plane) { return Grid::BOUND_COUNT - (odd_plane ? 1 : 0); }
+    /**
+     * Number of solution elements used on a plane in a half step.
+     */
+    static size_t plane_size(Grid const & grid, bool odd_plane) { return grid.nselm() + (odd_plane ? 1 : 0); }
 
     Kernel() { reset(); }
     void reset();
@@ -56,16 +86,90 @@ public:
     calc_type2 const & cfl_updater() const { return m_cfl_updater; }
     calc_type2       & cfl_updater()       { return m_cfl_updater; }
 
+    // Plane accessors.
+    calc_plane_type1 const & xn_plane_calc() const { return m_xn_plane_calc; }
+    calc_plane_type1       & xn_plane_calc()       { return m_xn_plane_calc; }
+    calc_plane_type1 const & xp_plane_calc() const { return m_xp_plane_calc; }
+    calc_plane_type1       & xp_plane_calc()       { return m_xp_plane_calc; }
+    calc_plane_type1 const & tn_plane_calc() const { return m_tn_plane_calc; }
+    calc_plane_type1       & tn_plane_calc()       { return m_tn_plane_calc; }
+    calc_plane_type1 const & tp_plane_calc() const { return m_tp_plane_calc; }
+    calc_plane_type1       & tp_plane_calc()       { return m_tp_plane_calc; }
+    calc_plane_type1 const & so0p_plane_calc() const { return m_so0p_plane_calc; }
+    calc_plane_type1       & so0p_plane_calc()       { return m_so0p_plane_calc; }
+    calc_plane_type2 const & cfl_plane_updater() const { return m_cfl_plane_updater; }
+    calc_plane_type2       & cfl_plane_updater()       { return m_cfl_plane_updater; }
+    bool has_plane_hook() const
+    {
+        return m_xn_plane_calc || m_xp_plane_calc || m_tn_plane_calc || m_tp_plane_calc
+            || m_so0p_plane_calc || m_cfl_plane_updater;
+    }
+
     // Calculating functions.
-    value_type calc_xn(Selm const & se, size_t iv) const { return m_xn_calc(se, iv); }
-    value_type calc_xp(Selm const & se, size_t iv) const { return m_xp_calc(se, iv); }
-    value_type calc_tn(Selm const & se, size_t iv) const { return m_tn_calc(se, iv); }
-    value_type calc_tp(Selm const & se, size_t iv) const { return m_tp_calc(se, iv); }
-    value_type calc_so0p(Selm const & se, size_t iv) const { return m_so0p_calc(se, iv); }
+    value_type calc_xn(Selm const & se, size_t iv) const;
+    value_type calc_xp(Selm const & se, size_t iv) const;
+    value_type calc_tn(Selm const & se, size_t iv) const;
+    value_type calc_tp(Selm const & se, size_t iv) const;
+    value_type calc_so0p(Selm const & se, size_t iv) const;
     void update_cfl(Selm & se) { m_cfl_updater(se); }
 
+    // Plane calculating functions.  They do nothing when no plane hook is set.
+    void calc_plane_flux(Field const & field, bool odd_plane);
+    void calc_plane_so0p(Field const & field, bool odd_plane);
+    /**
+     * @return true if the plane hook updated the CFL numbers.
+     */
+    bool update_plane_cfl(Field & field, bool odd_plane);
+
+    /**
+     * Invalidate the results of the plane hooks.  The solvers call it after
+     * each half step and when they set the solution.  Code writing the
+     * solution through the arrays or the element proxies calls it before
+     * asking for the fluxes again.  Evaluating on demand is not thread-safe;
+     * the marching loops only read the results calculated beforehand.
+     */
+    void drop_plane() const;
+
+    /**
+     * Evaluate a plane hook into a new (xsize, nvar) array.
+     */
+    static array_type eval_plane(calc_plane_type1 const & calc, Field const & field, bool odd_plane);
+
+    /**
+     * Keep the results of the plane hooks valid for the lifetime of the
+     * object, which spans a half step, and drop them afterwards.
+     */
+    class PlaneScope
+    {
+    public:
+        explicit PlaneScope(Kernel & kernel) : m_kernel(kernel) {}
+        PlaneScope(PlaneScope const & ) = delete;
+        PlaneScope(PlaneScope       &&) = delete;
+        PlaneScope & operator=(PlaneScope const & ) = delete;
+        PlaneScope & operator=(PlaneScope       &&) = delete;
+        ~PlaneScope() { m_kernel.drop_plane(); }
+    private:
+        Kernel & m_kernel;
+    }; /* end class PlaneScope */
+
 private:
 
+    /**
+     * Result of a plane hook, indexed by coordinate, and the field, grid and
+     * plane it was calculated for.
+     */
+    struct PlaneResult
+    {
+        array_type values = array_type(std::vector<size_t>{0, 0});
+        bool valid = false;
+        bool odd_plane = false;
+        Field const * field = nullptr;
+        Grid const * grid = nullptr;
+    }; /* end struct PlaneResult */
+
+    static void calc_plane(calc_plane_type1 const & calc, Field const & field, bool odd_plane, PlaneResult & ret);
+    static value_type lookup_plane(calc_plane_type1 const & calc, PlaneResult & result, Selm const & se, size_t iv);
+
     calc_type1 m_xn_calc;
     calc_type1 m_xp_calc;
     calc_type1 m_tn_calc;
@@ -73,6 +177,21 @@ private:
     calc_type1 m_so0p_calc;
     calc_type2 m_cfl_updater;
 
+    calc_plane_type1 m_xn_plane_calc;
+    calc_plane_type1 m_xp_plane_calc;
+    calc_plane_type1 m_tn_plane_calc;
+    calc_plane_type1 m_tp_plane_calc;
+    calc_plane_type1 m_so0p_plane_calc;
+    calc_plane_type2 m_cfl_plane_updater;
+
+    // Results of the plane evaluation in the current half step, or on demand
+    // outside it.  Mutable as a cache of the const calculating functions.
+    mutable PlaneResult m_xn_plane;
+    mutable PlaneResult m_xp_plane;
+    mutable PlaneResult m_tn_plane;
+    mutable PlaneResult m_tp_plane;
+    mutable PlaneResult m_so0p_plane;
+
 }; /* end class Kernel */
 
 /**
@@ -110,27 +229,50 @@ public:
 
     void set_grid(std::shared_ptr<Grid> const & grid) { m_grid = grid; }
 
+    /**
+     * Replace the grid and allocate so0, so1 and cfl for it.
+     */
+    void reset_grid(std::shared_ptr<Grid> const & grid);
+
     Grid const & grid() const { return *m_grid; }
     Grid       & grid()       { return *m_grid; }
 
-    array_type const & so0() const { return m_so0; }
-    array_type       & so0()       { return m_so0; }
-    array_type const & so1() const { return m_so1; }
-    array_type       & so1()       { return m_so1; }
-    array_type const & cfl() const { return m_cfl; }
-    array_type       & cfl()       { return m_cfl; }
-
-    value_type const & so0(size_t it, size_t iv) const { return m_so0(it, iv); }
-    value_type       & so0(size_t it, size_t iv)       { return m_so0(it, iv); }
-    value_type const & so1(size_t it, size_t iv) const { return m_so1(it, iv); }
-    value_type       & so1(size_t it, size_t iv)       { return m_so1(it, iv); }
-    value_type const & cfl(size_t it) const { return m_cfl(it); }
-    value_type       & cfl(size_t it)       { return m_cfl(it); }
-
-    size_t nvar() const { return m_so0.shape()[1]; }
+    array_type const & so0() const { return *m_so0; }
+    array_type       & so0()       { return *m_so0; }
+    array_type const & so1() const { return *m_so1; }
+    array_type       & so1()       { return *m_so1; }
+    array_type const & cfl() const { return *m_cfl; }
+    array_type       & cfl()       { return *m_cfl; }
+
+    /**
+     * Shared ownership of the arrays.  The field drops an array when it
+     * reallocates, and the holders keep the old storage alive.
+     */
+    std::shared_ptr<array_type const> shared_so0() const { return m_so0.share(); }
+    std::shared_ptr<array_type      > shared_so0()       { return m_so0.share(); }
+    std::shared_ptr<array_type const> shared_so1() const { return m_so1.share(); }
+    std::shared_ptr<array_type      > shared_so1()       { return m_so1.share(); }
+    std::shared_ptr<array_type const> shared_cfl() const { return m_cfl.share(); }
+    std::shared_ptr<array_type      > shared_cfl()       { return m_cfl.share(); }
+
+    value_type const & so0(size_t it, size_t iv) const { return (*m_so0)(it, iv); }
+    value_type       & so0(size_t it, size_t iv)       { return (*m_so0)(it, iv); }
+    value_type const & so1(size_t it, size_t iv) const { return (*m_so1)(it, iv); }
+    value_type       & so1(size_t it, size_t iv)       { return (*m_so1)(it, iv); }
+    value_type const & cfl(size_t it) const { return (*m_cfl)(it); }
+    value_type       & cfl(size_t it)       { return (*m_cfl)(it); }
+
+    size_t nvar() const { return m_so0->shape()[1]; }
 
     void set_time_increment(value_type time_increment);
 
+    /**
+     * Reallocate so0, so1 and cfl as Grid::place_memory() does for the
+     * coordinates.  Pointers to the old arrays become invalid, but the
+     * holders from shared_so0() and the like keep them alive.
+     */
+    void place_memory(size_t nthread, size_t align, bool huge_pages);
+
     real_type time_increment() const { return m_time_increment; }
     real_type dt() const { return m_time_increment; }
     real_type hdt() const { return m_half_time_increment; }
@@ -157,9 +299,9 @@ private:
 
     std::shared_ptr<Grid> m_grid;
 
-    array_type m_so0;
-    array_type m_so1;
-    array_type m_cfl;
+    SharedArray<array_type> m_so0;
+    SharedArray<array_type> m_so1;
+    SharedArray<array_type> m_cfl;
 
     real_type m_time_increment = 0;
     // Cached value;
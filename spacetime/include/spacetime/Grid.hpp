@@ -5,8 +5,13 @@
  * BSD 3-Clause License, see COPYING
  */
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
 #include "spacetime/Grid_decl.hpp"
 #include "spacetime/Celm_decl.hpp"
+#include "spacetime/memory.hpp"
 
 namespace spacetime
 {
@@ -22,6 +27,14 @@ Grid::Grid(real_type xmin, real_type xmax, size_t ncelm, ctor_passkey const &)
             << ", ncelm=" << ncelm << ") invalid argument: ncelm smaller than 1"
         );
     }
+    if (ncelm > max_ncelm())
+    {
+        throw std::overflow_error(Formatter()
+            << "Grid::Grid(xmin=" << xmin << ", xmax=" << xmax
+            << ", ncelm=" << ncelm << ") invalid argument: ncelm greater than " << max_ncelm()
+            << " overflows sindex_type (build with SPACETIME_INDEX64)"
+        );
+    }
     if (xmin >= xmax)
     {
         throw std::invalid_argument(Formatter()
@@ -52,6 +65,14 @@ void Grid::init_from_array(array_type const & xloc)
             << "xloc.size()=" << xloc.size() << " smaller than 2"
         );
     }
+    if (xloc.size() - 1 > max_ncelm())
+    {
+        throw std::overflow_error(Formatter()
+            << "Grid::init_from_array(xloc) invalid arguments: "
+            << "xloc.size()=" << xloc.size() << " greater than " << max_ncelm() + 1
+            << " overflows sindex_type (build with SPACETIME_INDEX64)"
+        );
+    }
     for (size_t it=0; it<xloc.size()-1; ++it)
     {
         if (xloc[it] >= xloc[it+1])
@@ -96,6 +117,101 @@ void Grid::init_from_array(array_type const & xloc)
     }
 }
 
+inline
+std::shared_ptr<Grid> Grid::adapt(std::vector<int> const & flags) const
+{
+    if (flags.size() != m_ncelm)
+    {
+        throw std::invalid_argument(Formatter()
+            << "Grid::adapt(flags) invalid arguments: "
+            << "flags.size()=" << flags.size() << " != ncelm=" << m_ncelm
+        );
+    }
+    std::vector<real_type> xloc;
+    xloc.reserve(2*m_ncelm+1);
+    xloc.push_back(m_agrid[BOUND_COUNT]);
+    for (size_t it=0; it<m_ncelm; ++it)
+    {
+        const size_t ref = it*2 + BOUND_COUNT + 1;
+        if (flags[it] < 0 && it+1 < m_ncelm && flags[it+1] < 0)
+        {
+            xloc.push_back(m_agrid[ref+3]);
+            ++it;
+            continue;
+        }
+        if (flags[it] > 0) { xloc.push_back(m_agrid[ref]); }
+        xloc.push_back(m_agrid[ref+1]);
+    }
+    array_type arr(std::vector<size_t>{xloc.size()});
+    for (size_t it=0; it<xloc.size(); ++it) { arr[it] = xloc[it]; }
+    std::shared_ptr<Grid> ret = construct(arr);
+    if (has_geometry()) { ret->build_geometry(); }
+    return ret;
+}
+
+inline
+void Grid::build_geometry()
+{
+    const size_t nx = xsize();
+    real_type const * x = xptr();
+    // The entries without both neighbors are NaN.
+    m_geometry = array_type(std::vector<size_t>{NGEOMETRY * nx});
+    std::fill(m_geometry.data(), m_geometry.data() + m_geometry.size(), std::numeric_limits<real_type>::quiet_NaN());
+    real_type * xctr = m_geometry.data() + XCTR * nx;
+    real_type * disp = m_geometry.data() + DISP * nx;
+    real_type * dispneg = m_geometry.data() + DISPNEG * nx;
+    real_type * disppos = m_geometry.data() + DISPPOS * nx;
+    real_type * dxpos = m_geometry.data() + DXPOS * nx;
+    real_type * hdx = m_geometry.data() + HDX * nx;
+    real_type * rdx = m_geometry.data() + RDX * nx;
+    real_type * rdxpos = m_geometry.data() + RDXPOS * nx;
+    for (size_t it=0; it<nx-1; ++it)
+    {
+        dxpos[it] = x[it+1] - x[it];
+        rdxpos[it] = 1 / dxpos[it];
+    }
+    // Same operations as Selm, so that the cached values are identical.
+    for (size_t it=1; it<nx-1; ++it)
+    {
+        xctr[it] = (x[it-1] + x[it+1]) / 2;
+        disp[it] = x[it] - xctr[it];
+        dispneg[it] = 0.5 * (x[it] + x[it-1]) - xctr[it];
+        disppos[it] = 0.5 * (x[it] + x[it+1]) - xctr[it];
+        hdx[it] = std::min(x[it] - x[it-1], x[it+1] - x[it]);
+        rdx[it] = 1 / (x[it+1] - x[it-1]);
+    }
+}
+
+inline
+Grid::Geometry Grid::geometry() const
+{
+    if (!has_geometry())
+    {
+        throw std::runtime_error("Grid::geometry(): build_geometry() is not called");
+    }
+    const size_t nx = xsize();
+    Geometry ret;
+    ret.m_xctr = m_geometry.data() + XCTR * nx;
+    ret.m_disp = m_geometry.data() + DISP * nx;
+    ret.m_dispneg = m_geometry.data() + DISPNEG * nx;
+    ret.m_disppos = m_geometry.data() + DISPPOS * nx;
+    ret.m_dxpos = m_geometry.data() + DXPOS * nx;
+    ret.m_hdx = m_geometry.data() + HDX * nx;
+    ret.m_rdx = m_geometry.data() + RDX * nx;
+    ret.m_rdxpos = m_geometry.data() + RDXPOS * nx;
+    return ret;
+}
+
+inline
+void Grid::place_memory(size_t nthread, size_t align, bool huge_pages)
+{
+    m_agrid.coord() = place_rows(m_agrid.coord(), m_ncelm, nthread, align, huge_pages);
+    if (has_geometry())
+    {
+        m_geometry = place_rows(m_geometry, m_ncelm, nthread, align, huge_pages, NGEOMETRY);
+    }
+}
+
 } /* end namespace spacetime */
 
 /* vim: set et ts=4 sw=4: */
@@ -5,6 +5,7 @@
  * BSD 3-Clause License, see COPYING
  */
 
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -32,6 +33,15 @@ public:
     constexpr static size_t BOUND_COUNT = 2;
     static_assert(BOUND_COUNT >= 2, "BOUND_COUNT must be greater or equal to 2");
 
+    /**
+     * Maximum number of CEs, so that every coordinate index fits in
+     * sindex_type.  Build with SPACETIME_INDEX64 for larger grids.
+     */
+    constexpr static size_t max_ncelm()
+    {
+        return (static_cast<size_t>(std::numeric_limits<sindex_type>::max()) - 2*BOUND_COUNT) / 2;
+    }
+
 private:
 
     class ctor_passkey {};
@@ -71,6 +81,79 @@ public:
     array_type const & xcoord() const { return m_agrid.coord(); }
     array_type       & xcoord()       { return m_agrid.coord(); }
 
+    /**
+     * Create a grid by refining and coarsening the CEs on the even plane.  A
+     * CE with a positive flag is split into two at its center.  Two
+     * neighboring CEs both with negative flags are merged into one, pairing
+     * from the left.  Other CEs are kept.
+     */
+    std::shared_ptr<Grid> adapt(std::vector<int> const & flags) const;
+
+    /**
+     * Read-only view of the geometry cache.  The element of coordinate index
+     * i is an SE or CE centered at xcoord()[i], and spans the coordinates
+     * i-1 to i+1.  Valid for 1 <= i <= xsize()-2.
+     */
+    class Geometry
+    {
+
+    public:
+
+        real_type xctr(size_t i) const { return m_xctr[i]; }
+        // x - xctr.
+        real_type disp(size_t i) const { return m_disp[i]; }
+        // Center of [xneg, x] minus xctr.
+        real_type dispneg(size_t i) const { return m_dispneg[i]; }
+        // Center of [x, xpos] minus xctr.
+        real_type disppos(size_t i) const { return m_disppos[i]; }
+        real_type dxneg(size_t i) const { return m_dxpos[i-1]; }
+        real_type dxpos(size_t i) const { return m_dxpos[i]; }
+        // min(dxneg, dxpos).
+        real_type hdx(size_t i) const { return m_hdx[i]; }
+        // val / (xpos - xneg), by the reciprocal.
+        template< typename A > A div_dx(A val, size_t i) const { return val * static_cast<A>(m_rdx[i]); }
+        // val / dxpos, by the reciprocal.
+        template< typename A > A div_dxpos(A val, size_t i) const { return val * static_cast<A>(m_rdxpos[i]); }
+
+    private:
+
+        friend Grid;
+
+        real_type const * m_xctr = nullptr;
+        real_type const * m_disp = nullptr;
+        real_type const * m_dispneg = nullptr;
+        real_type const * m_disppos = nullptr;
+        real_type const * m_dxpos = nullptr;
+        real_type const * m_hdx = nullptr;
+        real_type const * m_rdx = nullptr;
+        real_type const * m_rdxpos = nullptr;
+
+    }; /* end class Geometry */
+
+    /**
+     * Cache the centers, displacements, lengths and reciprocal lengths of the
+     * elements in contiguous arrays.  The element-free sweeps (Sweep.hpp)
+     * then read them instead of calculating from the coordinates, and divide
+     * by multiplying the reciprocals, so the solution may differ from the
+     * uncached one by rounding.  Call it again after changing xcoord().
+     */
+    void build_geometry();
+    void clear_geometry() { m_geometry = array_type(std::vector<size_t>{0}); }
+    bool has_geometry() const { return 0 != m_geometry.size(); }
+    Geometry geometry() const;
+
+    /**
+     * Reallocate the coordinates and the geometry cache so that they are
+     * first touched by the threads marching the CEs with
+     * parallel_for_chunk(0, ncelm(), nthread, align), and advise huge pages
+     * for them if huge_pages (see memory.hpp).  Pointers to the old arrays
+     * and Geometry objects taken before become invalid, and so do the element
+     * proxies, which point to the coordinates.  Call it before creating the
+     * solvers on the grid, with the number of threads they will march with
+     * and align = cache_line_align(2 * nvar * sizeof(real_type)).
+     */
+    void place_memory(size_t nthread, size_t align, bool huge_pages);
+
 public:
 
     class CelmPK { private: CelmPK() = default; friend Celm; };
@@ -122,6 +205,10 @@ private:
     size_t m_ncelm;
 
     modmesh::AscendantGrid1d m_agrid;
+    // NGEOMETRY arrays of xsize, empty when not cached.  Not std::vector,
+    // which would touch the memory when allocating it.
+    array_type m_geometry = array_type(std::vector<size_t>{0});
+    enum { XCTR = 0, DISP, DISPNEG, DISPPOS, DXPOS, HDX, RDX, RDXPOS, NGEOMETRY };
 
     template<class ET> friend class ElementBase;
 
@@ -0,0 +1,294 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Marching of a solver in a background thread.
+ *
+ * The thread marches the solver in chunks of time steps and checks for
+ * cancellation between the chunks, so that the caller may watch the progress
+ * and stop the march without waiting for all steps.  The solver must not be
+ * accessed by other threads before the task is done.  The task records the
+ * solver as its owner, so that busy() tells whether a task is marching it,
+ * and a solver is marched by at most one task.  It also records the grid of
+ * the solver, which other solvers may share, so that busy_grid() tells
+ * whether the grid is read by a march.  The march function, the owner and
+ * the grid are released before the task is marked done, so that nothing the
+ * function holds is destroyed by the thread afterwards, and the solver is
+ * free when wait() returns.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "spacetime/system.hpp"
+
+namespace spacetime
+{
+
+class MarchTask
+  : public std::enable_shared_from_this<MarchTask>
+{
+
+private:
+
+    class ctor_passkey {};
+
+public:
+
+    /**
+     * March the given number of time steps.
+     */
+    using march_type = std::function<void (size_t)>;
+
+    /**
+     * Start marching steps time steps, chunk steps per call to march.  The
+     * thread owns the task until it finishes, so dropping the returned
+     * pointer does not stop the march.  Call cancel() for that.  owner is the
+     * solver marched by march, and it may not be marched by another task.
+     * grid is the grid of the solver.
+     */
+    static std::shared_ptr<MarchTask> construct
+    (
+        march_type march, size_t steps, size_t chunk=1, void const * owner=nullptr, void const * grid=nullptr
+    )
+    {
+        if (chunk < 1)
+        {
+            throw std::invalid_argument("MarchTask: chunk smaller than 1");
+        }
+        std::shared_ptr<MarchTask> ret = std::make_shared<MarchTask>(std::move(march), steps, chunk, ctor_passkey());
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            if (owner && find_owner(owner))
+            {
+                throw std::runtime_error("MarchTask: the solver is already marched by another task");
+            }
+            ret->m_owner = owner;
+            ret->m_grid = grid;
+            registry().insert(ret.get());
+        }
+        try
+        {
+            std::thread(&MarchTask::run, ret).detach();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            registry().erase(ret.get());
+            throw;
+        }
+        return ret;
+    }
+
+    /**
+     * Cancel all tasks not finished and wait for them.  Python calls it at
+     * exit, so that no march outlives the interpreter.
+     */
+    static void cancel_all()
+    {
+        std::vector<std::shared_ptr<MarchTask>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            // A registered task is alive: its thread unregisters it before
+            // dropping the last reference.
+            for (MarchTask * task : registry()) { tasks.push_back(task->shared_from_this()); }
+        }
+        for (auto const & task : tasks) { task->cancel(); }
+        for (auto const & task : tasks) { task->wait(); }
+    }
+
+    /**
+     * Return true if a task not done is marching the owner and the caller is
+     * not its thread.
+     */
+    static bool busy(void const * owner)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        MarchTask const * task = find_owner(owner);
+        return task && task->m_thread != std::this_thread::get_id();
+    }
+
+    /**
+     * Return true if a task not done is marching a solver on the grid and the
+     * caller is not its thread.
+     */
+    static bool busy_grid(void const * grid)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (MarchTask const * task : registry())
+        {
+            if (task->m_grid == grid && task->m_thread != std::this_thread::get_id()) { return true; }
+        }
+        return false;
+    }
+
+    MarchTask(march_type march, size_t steps, size_t chunk, ctor_passkey const &)
+      : m_march(std::move(march))
+      , m_steps(steps)
+      , m_chunk(chunk)
+    {}
+
+    MarchTask() = delete;
+    MarchTask(MarchTask const & ) = delete;
+    MarchTask(MarchTask       &&) = delete;
+    MarchTask & operator=(MarchTask const & ) = delete;
+    MarchTask & operator=(MarchTask       &&) = delete;
+    ~MarchTask() = default;
+
+    size_t steps() const { return m_steps; }
+    size_t chunk() const { return m_chunk; }
+
+    /**
+     * Number of time steps marched so far.
+     */
+    size_t progress() const { return m_progress.load(); }
+
+    bool done() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_done;
+    }
+
+    /**
+     * Request the march to stop after the current chunk.
+     */
+    void cancel() { m_cancel.store(true); }
+    bool cancelled() const { return m_cancel.load(); }
+
+    /**
+     * Wait for the task to finish, for at most timeout seconds if it is not
+     * negative.  Return whether the task is done.
+     */
+    bool wait(double timeout=-1) const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (timeout < 0)
+        {
+            m_cv.wait(lock, [this]{ return m_done; });
+        }
+        else
+        {
+            m_cv.wait_for(lock, std::chrono::duration<double>(timeout), [this]{ return m_done; });
+        }
+        return m_done;
+    }
+
+    /**
+     * Wait for the task to finish, and rethrow the exception thrown by the
+     * march, if any.
+     */
+    void get() const
+    {
+        wait();
+        if (m_error) { std::rethrow_exception(m_error); }
+    }
+
+private:
+
+    void run()
+    {
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            m_thread = std::this_thread::get_id();
+        }
+        std::exception_ptr error;
+        try
+        {
+            while (!m_cancel.load() && m_progress.load() < m_steps)
+            {
+                const size_t nstep = std::min(m_chunk, m_steps - m_progress.load());
+                m_march(nstep);
+                m_progress.fetch_add(nstep);
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        // It may hold the last reference to the solver.
+        m_march = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            m_owner = nullptr;
+            m_grid = nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = error;
+            m_done = true;
+        }
+        m_cv.notify_all();
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry().erase(this);
+    }
+
+    // Call with registry_mutex() locked.
+    static MarchTask const * find_owner(void const * owner)
+    {
+        for (MarchTask const * task : registry())
+        {
+            if (task->m_owner == owner) { return task; }
+        }
+        return nullptr;
+    }
+
+    // Never destroyed, because a detached thread may unregister its task
+    // after the static objects are destroyed at exit.
+    static std::mutex & registry_mutex()
+    {
+        static std::mutex * mutex = new std::mutex;
+        return *mutex;
+    }
+
+    static std::set<MarchTask *> & registry()
+    {
+        static std::set<MarchTask *> * tasks = new std::set<MarchTask *>;
+        return *tasks;
+    }
+
+    march_type m_march;
+    // Guarded by registry_mutex().
+    void const * m_owner = nullptr;
+    void const * m_grid = nullptr;
+    std::thread::id m_thread;
+    size_t m_steps;
+    size_t m_chunk;
+    std::atomic<size_t> m_progress{0};
+    std::atomic<bool> m_cancel{false};
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_cv;
+    bool m_done = false;
+    std::exception_ptr m_error;
+
+}; /* end class MarchTask */
+
+/**
+ * Start marching the solver with march_alpha<ALPHA>() in a background
+ * thread.  The task keeps the solver alive and owns it until done.
+ */
+template< size_t ALPHA, typename ST >
+inline std::shared_ptr<MarchTask> march_alpha_async(std::shared_ptr<ST> const & sol, size_t steps, size_t chunk=1)
+{
+    return MarchTask::construct
+    (
+        [sol](size_t nstep) { sol->template march_alpha<ALPHA>(nstep); }, steps, chunk, sol.get(), &sol->grid()
+    );
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Solver with the physics supplied by a compile-time flux policy.
+ *
+ * A policy is a struct of static member functions with the same signatures
+ * as the hooks in Kernel:
+ *
+ *   static value_type xn(Selm const & se, size_t iv);
+ *   static value_type xp(Selm const & se, size_t iv);
+ *   static value_type tn(Selm const & se, size_t iv);
+ *   static value_type tp(Selm const & se, size_t iv);
+ *   static value_type so0p(Selm const & se, size_t iv);
+ *   static void update_cfl(Selm & se);
+ *
+ * Deriving from KernelPolicy provides the same defaults as Kernel::reset(),
+ * so a policy only needs to define the functions it overrides.  The calls are
+ * resolved at compile time and inlined into the marching loops of SolverBase,
+ * while Solver and its Kernel hooks remain available for prototyping.
+ */
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/ElementBase_decl.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/Field_decl.hpp"
+#include "spacetime/SolverBase_decl.hpp"
+#include "spacetime/Selm_decl.hpp"
+#include "spacetime/Celm_decl.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Default flux policy.  Matches the default hooks of Kernel.
+ */
+struct KernelPolicy
+{
+
+    using value_type = Selm::value_type;
+
+    static value_type xn(Selm const & /*se*/, size_t /*iv*/) { return 0.0; }
+    static value_type xp(Selm const & /*se*/, size_t /*iv*/) { return 0.0; }
+    static value_type tn(Selm const & /*se*/, size_t /*iv*/) { return 0.0; }
+    static value_type tp(Selm const & /*se*/, size_t /*iv*/) { return 0.0; }
+    static value_type so0p(Selm const & se, size_t iv) { return se.so0(iv); }
+    static void update_cfl(Selm & se) { se.cfl() = 0.0; }
+
+}; /* end struct KernelPolicy */
+
+template< typename KP >
+class PolicySelm
+  : public Selm
+{
+
+public:
+
+    using base_type = Selm;
+    using base_type::base_type;
+    using policy_type = KP;
+
+    value_type xn(size_t iv) const { return KP::xn(*this, iv); }
+    value_type xp(size_t iv) const { return KP::xp(*this, iv); }
+    value_type tn(size_t iv) const { return KP::tn(*this, iv); }
+    value_type tp(size_t iv) const { return KP::tp(*this, iv); }
+    value_type so0p(size_t iv) const { return KP::so0p(*this, iv); }
+    void update_cfl() { KP::update_cfl(*this); }
+
+}; /* end class PolicySelm */
+
+template< typename KP >
+using PolicyCelm = CelmBase<PolicySelm<KP>>;
+
+template< typename KP >
+class PolicySolver
+  : public SolverBase<PolicySolver<KP>, PolicyCelm<KP>, PolicySelm<KP>>
+{
+
+public:
+
+    using base_type = SolverBase<PolicySolver<KP>, PolicyCelm<KP>, PolicySelm<KP>>;
+    using base_type::base_type;
+    using value_type = typename base_type::value_type;
+    using policy_type = KP;
+
+    static std::shared_ptr<PolicySolver<KP>>
+    construct(std::shared_ptr<Grid> const & grid, value_type time_increment, size_t nvar)
+    {
+        return base_type::construct_impl(grid, time_increment, nvar);
+    }
+
+}; /* end class PolicySolver */
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,168 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Per-phase timing of the marching loops.
+ *
+ * The timers are compiled in only when SPACETIME_PROFILE is defined (CMake
+ * option USE_PROFILE).  Otherwise Profiler::Scope is empty, the records stay
+ * zero, and the marching code is the same as without the timers.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+#include "spacetime/system.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Wall time, number of calls and number of elements processed by the phases
+ * of marching.  A phase called inside another timed phase is counted in the
+ * outer one, so that the times of the phases add up.  The records are
+ * updated by the thread calling the marching functions only.
+ */
+class Profiler
+{
+
+public:
+
+    enum Phase : size_t
+    {
+        // Calculate so0 of the CEs on a plane (march_half_so0()).
+        SO0 = 0
+        // Calculate the CFL numbers of the SEs on a plane (update_cfl()).
+      , CFL
+        // Calculate so1 of the CEs on a plane (march_half_so1_alpha()).
+      , SO1
+        // Treat the boundary SEs (treat_boundary_so0(), treat_boundary_so1()).
+      , BOUNDARY
+        // Calculate so0, CFL and so1 of the CEs on a plane in one pass
+        // (march_half_fused_alpha()), without the boundary.
+      , FUSED
+        // March time steps with temporal blocking, boundary included.
+      , BLOCK
+        // March time steps with local time stepping, boundary included.
+      , LTS
+      , NPHASE
+    };
+
+    struct Record
+    {
+        double seconds = 0;
+        size_t ncall = 0;
+        // Number of CEs or SEs processed.
+        size_t nelm = 0;
+        /**
+         * Elements processed per second.
+         */
+        double throughput() const { return seconds > 0 ? nelm / seconds : 0; }
+    };
+
+    static char const * phase_name(Phase phase)
+    {
+        static char const * const names[NPHASE] = {"so0", "cfl", "so1", "boundary", "fused", "block", "lts"};
+        if (phase >= NPHASE) { throw std::out_of_range(Formatter() << "phase_name(): phase " << phase << " >= " << NPHASE); }
+        return names[phase];
+    }
+
+    static constexpr bool enabled()
+    {
+#ifdef SPACETIME_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    Record const & record(Phase phase) const
+    {
+        if (phase >= NPHASE) { throw std::out_of_range(Formatter() << "record(): phase " << phase << " >= " << NPHASE); }
+        return m_records[phase];
+    }
+
+    void reset() { m_records.fill(Record()); }
+
+#ifdef SPACETIME_PROFILE
+
+    /**
+     * Time the enclosing block as a phase processing nelm elements.
+     */
+    class Scope
+    {
+
+    public:
+
+        Scope(Profiler & profiler, Phase phase, size_t nelm)
+          : m_profiler(profiler.m_depth > 0 ? nullptr : &profiler)
+          , m_phase(phase)
+          , m_nelm(nelm)
+        {
+            if (m_profiler)
+            {
+                ++m_profiler->m_depth;
+                m_start = clock_type::now();
+            }
+        }
+
+        Scope(Scope const & ) = delete;
+        Scope(Scope       &&) = delete;
+        Scope & operator=(Scope const & ) = delete;
+        Scope & operator=(Scope       &&) = delete;
+
+        ~Scope()
+        {
+            if (m_profiler)
+            {
+                Record & rec = m_profiler->m_records[m_phase];
+                rec.seconds += std::chrono::duration<double>(clock_type::now() - m_start).count();
+                ++rec.ncall;
+                rec.nelm += m_nelm;
+                --m_profiler->m_depth;
+            }
+        }
+
+    private:
+
+        using clock_type = std::chrono::steady_clock;
+
+        Profiler * m_profiler;
+        Phase m_phase;
+        size_t m_nelm;
+        clock_type::time_point m_start;
+
+    }; /* end class Scope */
+
+#else // SPACETIME_PROFILE
+
+    class Scope
+    {
+
+    public:
+
+        Scope(Profiler &, Phase, size_t) {}
+
+    }; /* end class Scope */
+
+#endif // SPACETIME_PROFILE
+
+private:
+
+    std::array<Record, NPHASE> m_records;
+#ifdef SPACETIME_PROFILE
+    // Nesting level of the active scopes.  Only the outermost one records.
+    size_t m_depth = 0;
+#endif
+
+}; /* end class Profiler */
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
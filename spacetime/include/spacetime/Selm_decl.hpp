@@ -70,6 +70,8 @@ public:
     value_type so0p(size_t iv) const { return field().kernel().calc_so0p(*this, iv); }
     void update_cfl() { return field().kernel().update_cfl(*this); }
 
+    friend Kernel;
+
 }; /* end class Selm */
 
 inline void Kernel::reset()
@@ -80,8 +82,48 @@ inline void Kernel::reset()
     m_tp_calc = [](Selm const &, size_t) { return 0.0; };
     m_so0p_calc = [](Selm const & se, size_t iv) { return se.so0(iv); };
     m_cfl_updater = [](Selm & se) { se.cfl() = 0.0; };
+    m_xn_plane_calc = nullptr;
+    m_xp_plane_calc = nullptr;
+    m_tn_plane_calc = nullptr;
+    m_tp_plane_calc = nullptr;
+    m_so0p_plane_calc = nullptr;
+    m_cfl_plane_updater = nullptr;
+    drop_plane();
+}
+
+/**
+ * Take the value of the SE from the result of the plane hook when the result
+ * was calculated for the field, grid and plane of the SE.  Otherwise evaluate
+ * the plane hook for the plane of the SE and keep the result for the other
+ * SEs on it.
+ */
+inline Kernel::value_type Kernel::lookup_plane(calc_plane_type1 const & calc, PlaneResult & result, Selm const & se, size_t iv)
+{
+    Field const & field = se.field();
+    if (!(result.valid && result.odd_plane == se.on_odd_plane()
+       && result.field == &field && result.grid == &field.grid()
+       && field.grid().xsize() == result.values.shape()[0] && field.nvar() == result.values.shape()[1]))
+    {
+        calc_plane(calc, field, se.on_odd_plane(), result);
+    }
+    return result.values(se.xindex(), iv);
+}
+
+#define SPACETIME_KERNEL_CALC(NAME) \
+inline Kernel::value_type Kernel::calc_ ## NAME(Selm const & se, size_t iv) const \
+{ \
+    if (m_ ## NAME ## _plane_calc) { return lookup_plane(m_ ## NAME ## _plane_calc, m_ ## NAME ## _plane, se, iv); } \
+    return m_ ## NAME ## _calc(se, iv); \
 }
 
+SPACETIME_KERNEL_CALC(xn)
+SPACETIME_KERNEL_CALC(xp)
+SPACETIME_KERNEL_CALC(tn)
+SPACETIME_KERNEL_CALC(tp)
+SPACETIME_KERNEL_CALC(so0p)
+
+#undef SPACETIME_KERNEL_CALC
+
 } /* end namespace spacetime */
 
 /* vim: set et ts=4 sw=4: */
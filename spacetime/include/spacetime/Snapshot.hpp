@@ -0,0 +1,313 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Append-only time series of Field snapshots.
+ *
+ * The file starts with SnapshotWriter::FileHeader and is followed by one chunk
+ * for each snapshot.  A chunk is SnapshotWriter::ChunkHeader followed by the
+ * coordinate array of the Grid, so0 and so1, all in the native double format.
+ * The chunks are self-contained, so that a remeshed grid or a truncated last
+ * chunk does not affect the others.
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/Field_decl.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Write snapshots of a Field on a background thread.  push() copies the
+ * arrays into one of two buffers and returns; the thread writes the buffers
+ * in order, so that the I/O overlaps with marching.  push() blocks only when
+ * both buffers are still waiting to be written.  The writer takes a single
+ * producer.
+ */
+class SnapshotWriter
+{
+
+public:
+
+    using value_type = Field::value_type;
+
+    enum : uint32_t
+    {
+        VERSION = 1
+      , BYTE_ORDER_MARK = 0x01020304
+    };
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+    }; /* end struct FileHeader */
+
+    struct ChunkHeader
+    {
+        uint64_t step;
+        value_type time_increment;
+        uint64_t ncelm;
+        uint64_t nvar;
+        uint64_t xsize;
+    }; /* end struct ChunkHeader */
+
+    static char const * magic() { return "LIBSTSNP"; }
+
+    /**
+     * Number of values following the chunk header.
+     */
+    static uint64_t chunk_size(ChunkHeader const & header) { return header.xsize * (1 + 2*header.nvar); }
+
+    /**
+     * Open the file and start the writing thread.  With append, the chunks
+     * are added to the end of an existing file.
+     */
+    explicit SnapshotWriter(std::string const & path, bool append=false)
+      : m_path(path)
+    {
+        std::ios::openmode mode = std::ios::binary | std::ios::out;
+        mode |= append ? std::ios::app : std::ios::trunc;
+        m_stream.open(path, mode);
+        if (!m_stream) { throw std::runtime_error(Formatter() << "SnapshotWriter: cannot open " << path); }
+        if (0 == m_stream.tellp())
+        {
+            FileHeader header{};
+            std::memcpy(header.magic, magic(), sizeof(header.magic));
+            header.version = VERSION;
+            header.byte_order = BYTE_ORDER_MARK;
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            m_stream.write(reinterpret_cast<char const *>(&header), sizeof(FileHeader));
+        }
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    SnapshotWriter() = delete;
+    SnapshotWriter(SnapshotWriter const & ) = delete;
+    SnapshotWriter(SnapshotWriter       &&) = delete;
+    SnapshotWriter & operator=(SnapshotWriter const & ) = delete;
+    SnapshotWriter & operator=(SnapshotWriter       &&) = delete;
+
+    ~SnapshotWriter()
+    {
+        try { close(); }
+        catch (...) {} // NOLINT(bugprone-empty-catch)
+    }
+
+    std::string const & path() const { return m_path; }
+
+    /**
+     * Number of chunks written to the file.
+     */
+    size_t nchunk() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_nchunk;
+    }
+
+    /**
+     * Queue a snapshot of the field.  An error of the writing thread is
+     * rethrown here.
+     */
+    void push(Field const & field, uint64_t step)
+    {
+        Buffer * buf = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_closed) { throw std::runtime_error(Formatter() << "SnapshotWriter: " << m_path << " is closed"); }
+            m_cond.wait(lock, [this]() { return !m_buffer[m_push].full || m_error; });
+            rethrow();
+            buf = &m_buffer[m_push];
+        }
+        // The writing thread does not touch a buffer that is not full.
+        ChunkHeader & header = buf->header;
+        header.step = step;
+        header.time_increment = field.time_increment();
+        header.ncelm = field.grid().ncelm();
+        header.nvar = field.nvar();
+        header.xsize = field.grid().xsize();
+        const size_t xsize = header.xsize;
+        const size_t nso = xsize * header.nvar;
+        buf->data.resize(chunk_size(header));
+        std::memcpy(buf->data.data(), field.grid().xcoord().data(), xsize * sizeof(value_type));
+        std::memcpy(buf->data.data() + xsize, field.so0().data(), nso * sizeof(value_type));
+        std::memcpy(buf->data.data() + xsize + nso, field.so1().data(), nso * sizeof(value_type));
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            buf->full = true;
+            m_push ^= 1;
+        }
+        m_cond.notify_all();
+    }
+
+    /**
+     * Wait until the queued snapshots are written.
+     */
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() { return (!m_buffer[0].full && !m_buffer[1].full) || m_error; });
+        rethrow();
+    }
+
+    /**
+     * Write the queued snapshots, stop the thread and close the file.
+     */
+    void close()
+    {
+        if (m_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+            }
+            m_cond.notify_all();
+            m_thread.join();
+            m_stream.close();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        rethrow();
+    }
+
+private:
+
+    struct Buffer
+    {
+        ChunkHeader header;
+        std::vector<value_type> data;
+        bool full = false;
+    }; /* end struct Buffer */
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_cond.wait(lock, [this]() { return m_buffer[m_pop].full || m_closed; });
+            Buffer & buf = m_buffer[m_pop];
+            if (!buf.full) { break; }
+            lock.unlock();
+            try
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                m_stream.write(reinterpret_cast<char const *>(&buf.header), sizeof(ChunkHeader));
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                m_stream.write(reinterpret_cast<char const *>(buf.data.data()),
+                               static_cast<std::streamsize>(buf.data.size() * sizeof(value_type)));
+                m_stream.flush();
+                if (!m_stream) { throw std::runtime_error(Formatter() << "SnapshotWriter: failed to write " << m_path); }
+            }
+            catch (...)
+            {
+                lock.lock();
+                m_error = std::current_exception();
+                m_cond.notify_all();
+                break;
+            }
+            lock.lock();
+            buf.full = false;
+            m_pop ^= 1;
+            ++m_nchunk;
+            m_cond.notify_all();
+        }
+    }
+
+    // Must be called with m_mutex locked.  The thread stops at an error, so
+    // that the error is kept and rethrown by every later call.
+    void rethrow() const
+    {
+        if (m_error) { std::rethrow_exception(m_error); }
+    }
+
+    std::string m_path;
+    std::ofstream m_stream;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    Buffer m_buffer[2];
+    size_t m_push = 0;
+    size_t m_pop = 0;
+    size_t m_nchunk = 0;
+    bool m_closed = false;
+    std::exception_ptr m_error;
+    std::thread m_thread;
+
+}; /* end class SnapshotWriter */
+
+/**
+ * Read the chunks written by SnapshotWriter one after another.
+ */
+class SnapshotReader
+{
+
+public:
+
+    using value_type = SnapshotWriter::value_type;
+    using ChunkHeader = SnapshotWriter::ChunkHeader;
+
+    explicit SnapshotReader(std::string const & path)
+      : m_stream(path, std::ios::binary)
+    {
+        if (!m_stream) { throw std::runtime_error(Formatter() << "SnapshotReader: cannot open " << path); }
+        SnapshotWriter::FileHeader header{};
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        m_stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!m_stream || 0 != std::memcmp(header.magic, SnapshotWriter::magic(), sizeof(header.magic)))
+        {
+            throw std::runtime_error(Formatter() << "SnapshotReader: " << path << " is not a snapshot file");
+        }
+        if (SnapshotWriter::BYTE_ORDER_MARK != header.byte_order || SnapshotWriter::VERSION != header.version)
+        {
+            throw std::runtime_error(Formatter() << "SnapshotReader: " << path << " has a different byte order or version");
+        }
+    }
+
+    /**
+     * Read the next chunk.  Return false at the end of the file or at a
+     * truncated chunk.
+     */
+    bool next()
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        m_stream.read(reinterpret_cast<char *>(&m_header), sizeof(ChunkHeader));
+        if (!m_stream) { return false; }
+        m_data.resize(SnapshotWriter::chunk_size(m_header));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        m_stream.read(reinterpret_cast<char *>(m_data.data()),
+                      static_cast<std::streamsize>(m_data.size() * sizeof(value_type)));
+        return static_cast<bool>(m_stream);
+    }
+
+    ChunkHeader const & header() const { return m_header; }
+    value_type const * xcoord() const { return m_data.data(); }
+    value_type const * so0() const { return m_data.data() + m_header.xsize; }
+    value_type const * so1() const { return m_data.data() + m_header.xsize * (1 + m_header.nvar); }
+
+private:
+
+    std::ifstream m_stream;
+    ChunkHeader m_header{};
+    std::vector<value_type> m_data;
+
+}; /* end class SnapshotReader */
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
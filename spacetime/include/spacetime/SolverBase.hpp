@@ -37,6 +37,13 @@ SolverBase<ST,CE,SE>::get_so0p(size_t iv, bool odd_plane) const
     if (iv >= m_field.nvar()) { throw std::out_of_range("get_so0p(): out of nvar range"); }
     const index_type nselm = grid().nselm() - odd_plane;
     array_type ret(std::vector<size_t>{nselm});
+    if (std::is_same<SE, Selm>::value && kernel().so0p_plane_calc())
+    {
+        // Evaluate the plane hook once for the plane rather than once per SE.
+        array_type const plane = Kernel::eval_plane(kernel().so0p_plane_calc(), m_field, odd_plane);
+        for (index_type it=0; it<nselm; ++it) { ret[it] = plane(plane_xindex(odd_plane) + 2*it, iv); }
+        return ret;
+    }
     for (index_type it=0; it<nselm; ++it) { ret[it] = selm(it, odd_plane).so0p(iv); }
     return ret;
 }
@@ -77,18 +84,48 @@ SolverBase<ST,CE,SE>::set_so0(size_t iv, typename SolverBase<ST,CE,SE>::array_ty
     {
         throw std::out_of_range(Formatter() << "set_so0(): arr size " << arr.size() << " != nselm " << nselm);
     }
-    for (index_type it=0; it<nselm; ++it) { selm(it, odd_plane).so0(iv) = arr[it]; }
+    import_plane(m_field.so0(), arr.data(), 1, 0, iv, 1, odd_plane);
 }
 
 template< typename ST, typename CE, typename SE >
 inline void
 SolverBase<ST,CE,SE>::set_so1(size_t iv, typename SolverBase<ST,CE,SE>::array_type const & arr, bool odd_plane)
 {
-    if (iv >= m_field.nvar()) { throw std::out_of_range("set_so1(): out of nvar range"); }
+    if (iv >= m_field.nvar())
+    {
+        throw std::out_of_range(Formatter() << "set_so1(): iv " << iv << " >= nvar " << m_field.nvar());
+    }
     if (1 != arr.shape().size()) { throw std::out_of_range("set_so1(): input not 1D"); }
     const index_type nselm = grid().nselm() - odd_plane;
-    if (nselm != arr.size()) { throw std::out_of_range("set_so1(): input wrong size"); }
-    for (index_type it=0; it<nselm; ++it) { selm(it, odd_plane).so1(iv) = arr[it]; }
+    if (nselm != arr.size())
+    {
+        throw std::out_of_range(Formatter() << "set_so1(): arr size " << arr.size() << " != nselm " << nselm);
+    }
+    import_plane(m_field.so1(), arr.data(), 1, 0, iv, 1, odd_plane);
+}
+
+template< typename ST, typename CE, typename SE >
+inline void SolverBase<ST,CE,SE>::import_plane
+(
+    typename SolverBase<ST,CE,SE>::array_type & dst
+  , value_type const * data
+  , sindex_type row_stride
+  , sindex_type col_stride
+  , size_t ivbegin
+  , size_t nv
+  , bool odd_plane
+)
+{
+    m_field.kernel().drop_plane();
+    const size_t ncol = dst.size() / grid().xsize();
+    const size_t nselm = plane_nselm(odd_plane);
+    value_type * dptr = dst.data() + plane_xindex(odd_plane) * ncol + ivbegin;
+    for (size_t it=0; it<nselm; ++it)
+    {
+        value_type const * sptr = data + static_cast<std::ptrdiff_t>(it) * row_stride;
+        for (size_t jv=0; jv<nv; ++jv) { dptr[jv] = sptr[static_cast<std::ptrdiff_t>(jv) * col_stride]; }
+        dptr += 2 * ncol;
+    }
 }
 
 template< typename ST, typename CE, typename SE >
@@ -105,10 +142,13 @@ template< typename ST, typename CE, typename SE >
 inline void
 SolverBase<ST,CE,SE>::set_cfl(typename SolverBase<ST,CE,SE>::array_type const & arr, bool odd_plane)
 {
-    if (1 != arr.shape().size()) { throw std::out_of_range("set_so1(): input not 1D"); }
+    if (1 != arr.shape().size()) { throw std::out_of_range("set_cfl(): input not 1D"); }
     const index_type nselm = grid().nselm() - odd_plane;
-    if (nselm != arr.size()) { throw std::out_of_range("set_so1(): input wrong size"); }
-    for (index_type it=0; it<nselm; ++it) { selm(it, odd_plane).cfl() = arr[it]; }
+    if (nselm != arr.size())
+    {
+        throw std::out_of_range(Formatter() << "set_cfl(): arr size " << arr.size() << " != nselm " << nselm);
+    }
+    import_plane(m_field.cfl(), arr.data(), 1, 0, 0, 1, odd_plane);
 }
 
 template< typename ST, typename CE, typename SE >
@@ -116,11 +156,28 @@ inline void SolverBase<ST,CE,SE>::march_half_so0(bool odd_plane)
 {
     const sindex_type start = odd_plane ? -1 : 0;
     const sindex_type stop = grid().ncelm();
-    for (sindex_type ic=start; ic<stop; ++ic)
+    const Profiler::Scope timer(m_profiler, Profiler::SO0, stop - start);
+    if (m_use_sweep)
     {
-        auto ce = celm(ic, odd_plane);
-        ce.selm_tp().so0(0) = ce.calc_so0(0);
+        // Not a class-scope alias: ST is incomplete when SolverBase is
+        // instantiated as its base.
+        using sweep_type = typename detail::sweep_of<ST>::type;
+        parallel_for_chunk(start, stop, m_nthread, celm_align(), [this, odd_plane](sindex_type begin, sindex_type end)
+        {
+            sweep_type::march_so0(m_field, odd_plane, begin, end);
+        });
+        return;
     }
+    const size_t nvar = m_field.nvar();
+    const Kernel::PlaneScope plane_scope(m_field.kernel());
+    m_field.kernel().calc_plane_flux(m_field, odd_plane);
+    parallel_for(start, stop, m_nthread, celm_align(), [this, odd_plane, nvar](sindex_type ic)
+    {
+        auto ce = celm(ic, odd_plane);
+        auto se = ce.selm_tp();
+        // All variables of an SE are contiguous in the (xsize, nvar) array.
+        for (size_t iv=0; iv<nvar; ++iv) { se.so0(iv) = ce.calc_so0(iv); }
+    });
 }
 
 template< typename ST, typename CE, typename SE >
@@ -128,10 +185,77 @@ inline void SolverBase<ST,CE,SE>::update_cfl(bool odd_plane)
 {
     const sindex_type start = odd_plane ? -1 : 0;
     const sindex_type stop = grid().nselm();
-    for (sindex_type ic=start; ic<stop; ++ic)
+    const Profiler::Scope timer(m_profiler, Profiler::CFL, stop - start);
+    m_field.kernel().drop_plane();
+    const size_t align = cache_line_align(2 * sizeof(value_type));
+    if (!m_use_sweep && m_field.kernel().update_plane_cfl(m_field, odd_plane))
     {
-        selm(ic, odd_plane).update_cfl();
+        m_cfl_max = reduce_cfl_max(odd_plane, start, stop);
+        return;
     }
+    // Take the maximum of each chunk while its CFL numbers are in cache.
+    m_cfl_max = parallel_reduce_chunk<value_type>
+    (
+        start, stop, m_nthread, align
+      , [this, odd_plane](sindex_type begin, sindex_type end)
+        {
+            if (m_use_sweep)
+            {
+                using sweep_type = typename detail::sweep_of<ST>::type;
+                sweep_type::update_cfl(m_field, odd_plane, begin, end);
+            }
+            else
+            {
+                for (sindex_type is=begin; is<end; ++is) { selm(is, odd_plane).update_cfl(); }
+            }
+            return scan_cfl_max(odd_plane, begin, end);
+        }
+      , &max_cfl
+    );
+}
+
+/**
+ * Maximum CFL number of the SEs [begin, end) on the plane.  NaN propagates.
+ */
+template< typename ST, typename CE, typename SE >
+inline typename SolverBase<ST,CE,SE>::value_type
+SolverBase<ST,CE,SE>::scan_cfl_max(bool odd_plane, sindex_type begin, sindex_type end) const
+{
+    value_type ret = 0;
+    value_type const * cfl = m_field.cfl().data() + Grid::BOUND_COUNT + (odd_plane ? 1 : 0);
+    for (sindex_type is=begin; is<end; ++is) { ret = max_cfl(ret, cfl[is << 1]); }
+    return ret;
+}
+
+template< typename ST, typename CE, typename SE >
+inline typename SolverBase<ST,CE,SE>::value_type
+SolverBase<ST,CE,SE>::reduce_cfl_max(bool odd_plane, sindex_type start, sindex_type stop) const
+{
+    return parallel_reduce_chunk<value_type>
+    (
+        start, stop, m_nthread, cache_line_align(2 * sizeof(value_type))
+      , [this, odd_plane](sindex_type begin, sindex_type end) { return scan_cfl_max(odd_plane, begin, end); }
+      , &max_cfl
+    );
+}
+
+/**
+ * Update the CFL numbers of the two ghost SEs on the odd plane.
+ */
+template< typename ST, typename CE, typename SE >
+inline void SolverBase<ST,CE,SE>::update_ghost_cfl()
+{
+    const sindex_type ncelm = grid().ncelm();
+    const Profiler::Scope timer(m_profiler, Profiler::CFL, 2);
+    if (m_use_sweep)
+    {
+        using sweep_type = typename detail::sweep_of<ST>::type;
+        sweep_type::update_cfl(m_field, true, -1, 0);
+        sweep_type::update_cfl(m_field, true, ncelm, ncelm+1);
+        return;
+    }
+    selm(-1, true).update_cfl();
+    selm(ncelm, true).update_cfl();
 }
 
 template< typename ST, typename CE, typename SE >
@@ -140,41 +264,250 @@ inline void SolverBase<ST,CE,SE>::march_half_so1_alpha(bool odd_plane)
 {
     const sindex_type start = odd_plane ? -1 : 0;
     const sindex_type stop = grid().ncelm();
-    for (sindex_type ic=start; ic<stop; ++ic)
+    const Profiler::Scope timer(m_profiler, Profiler::SO1, stop - start);
+    if (m_use_sweep)
     {
-        auto ce = celm(ic, odd_plane);
-        ce.selm_tp().so1(0) = ce.template calc_so1_alpha<ALPHA>(0);
+        using sweep_type = typename detail::sweep_of<ST>::type;
+        parallel_for_chunk(start, stop, m_nthread, celm_align(), [this, odd_plane](sindex_type begin, sindex_type end)
+        {
+            sweep_type::template march_so1_alpha<ALPHA>(m_field, odd_plane, begin, end);
+        });
+        return;
     }
+    const size_t nvar = m_field.nvar();
+    const Kernel::PlaneScope plane_scope(m_field.kernel());
+    m_field.kernel().calc_plane_so0p(m_field, odd_plane);
+    parallel_for(start, stop, m_nthread, celm_align(), [this, odd_plane, nvar](sindex_type ic)
+    {
+        auto ce = celm(ic, odd_plane);
+        auto se = ce.selm_tp();
+        for (size_t iv=0; iv<nvar; ++iv) { se.so1(iv) = ce.template calc_so1_alpha<ALPHA>(iv); }
+    });
 }
 
 template< typename ST, typename CE, typename SE >
 inline void SolverBase<ST,CE,SE>::treat_boundary_so0()
 {
+    const Profiler::Scope timer(m_profiler, Profiler::BOUNDARY, 2);
+    m_field.kernel().drop_plane();
     SE const selm_left_in = selm(0, true);
     SE       selm_left_out = selm(-1, true);
     SE const selm_right_in = selm(grid().ncelm()-1, true);
     SE       selm_right_out = selm(grid().ncelm(), true);
 
-    selm_left_out.so0(0) = selm_right_in.so0(0);
-    selm_right_out.so0(0) = selm_left_in.so0(0);
+    m_left_boundary.treat(selm_left_out, selm_left_in, selm_right_in, 0);
+    m_right_boundary.treat(selm_right_out, selm_right_in, selm_left_in, 0);
 }
 
 template< typename ST, typename CE, typename SE >
 inline void SolverBase<ST,CE,SE>::treat_boundary_so1()
 {
+    const Profiler::Scope timer(m_profiler, Profiler::BOUNDARY, 2);
+    m_field.kernel().drop_plane();
     SE const selm_left_in = selm(0, true);
     SE       selm_left_out = selm(-1, true);
     SE const selm_right_in = selm(grid().ncelm()-1, true);
     SE       selm_right_out = selm(grid().ncelm(), true);
 
-    selm_left_out.so1(0) = selm_right_in.so1(0);
-    selm_right_out.so1(0) = selm_left_in.so1(0);
+    m_left_boundary.treat(selm_left_out, selm_left_in, selm_right_in, 1);
+    m_right_boundary.treat(selm_right_out, selm_right_in, selm_left_in, 1);
+}
+
+/**
+ * Calculate so0, CFL and so1 of the top SEs of the CEs [begin, end) on the
+ * plane, one CE after another.
+ */
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_fused_range(bool odd_plane, sindex_type begin, sindex_type end, bool plane_cfl)
+{
+    if (m_use_sweep)
+    {
+        using sweep_type = typename detail::sweep_of<ST>::type;
+        sweep_type::template march_fused_alpha<ALPHA>(m_field, odd_plane, begin, end);
+        return;
+    }
+    const size_t nvar = m_field.nvar();
+    for (sindex_type ic=begin; ic<end; ++ic)
+    {
+        auto ce = celm(ic, odd_plane);
+        auto se = ce.selm_tp();
+        for (size_t iv=0; iv<nvar; ++iv) { se.so0(iv) = ce.calc_so0(iv); }
+        if (!plane_cfl) { se.update_cfl(); }
+        for (size_t iv=0; iv<nvar; ++iv) { se.so1(iv) = ce.template calc_so1_alpha<ALPHA>(iv); }
+    }
+}
+
+/**
+ * Calculate so0, CFL and so1 of the top SEs of the CEs on the plane in one
+ * pass over the CEs, and then treat the boundary.  Gives the same solution as
+ * march_half1_alpha() and march_half2_alpha() with one traversal of the
+ * arrays instead of three.
+ *
+ * The so0 of a CE is calculated from the SEs on the other plane, which the
+ * pass does not write, and the CFL number and so1 of its top SE only need the
+ * updated so0 of the same SE.  The two ghost SEs after the first half step
+ * take their CFL numbers after the boundary treatment.  The plane hooks of
+ * Kernel for flux and so0p are evaluated before the pass, and a CFL plane
+ * hook after it.
+ */
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_half_fused_alpha(bool odd_plane)
+{
+    const sindex_type start = odd_plane ? -1 : 0;
+    const sindex_type stop = grid().ncelm();
+    const bool plane_cfl = !m_use_sweep && m_field.kernel().cfl_plane_updater();
+    {
+        const Profiler::Scope timer(m_profiler, Profiler::FUSED, stop - start);
+        const Kernel::PlaneScope plane_scope(m_field.kernel());
+        if (!m_use_sweep)
+        {
+            m_field.kernel().calc_plane_flux(m_field, odd_plane);
+            m_field.kernel().calc_plane_so0p(m_field, odd_plane);
+        }
+        // The top SE of CE ic is SE ic on the odd plane or SE ic+1 on the even
+        // plane.
+        const sindex_type top_offset = odd_plane ? 1 : 0;
+        m_cfl_max = parallel_reduce_chunk<value_type>
+        (
+            start, stop, m_nthread, celm_align()
+          , [this, odd_plane, plane_cfl, top_offset](sindex_type begin, sindex_type end)
+            {
+                march_fused_range<ALPHA>(odd_plane, begin, end, plane_cfl);
+                return scan_cfl_max(!odd_plane, begin + top_offset, end + top_offset);
+            }
+          , &max_cfl
+        );
+    }
+    if (!odd_plane)
+    {
+        treat_boundary_so0();
+        treat_boundary_so1();
+        if (!plane_cfl)
+        {
+            update_ghost_cfl();
+            const sindex_type ncelm = grid().ncelm();
+            m_cfl_max = max_cfl(m_cfl_max, max_cfl(scan_cfl_max(true, -1, 0), scan_cfl_max(true, ncelm, ncelm+1)));
+        }
+    }
+    if (plane_cfl)
+    {
+        const Profiler::Scope timer(m_profiler, Profiler::CFL, grid().nselm() + (odd_plane ? 0 : 1));
+        m_field.kernel().update_plane_cfl(m_field, !odd_plane);
+        m_cfl_max = reduce_cfl_max(!odd_plane, odd_plane ? 0 : -1, grid().nselm());
+    }
+}
+
+/**
+ * March the CEs on the plane whose coordinate indices are in [xbegin, xend).
+ */
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_fused_xrange(bool odd_plane, sindex_type xbegin, sindex_type xend)
+{
+    // Coordinate index of CE 0 on the plane; CEs are 2 indices apart.
+    const sindex_type xbase = 1 + Grid::BOUND_COUNT + (odd_plane ? 1 : 0);
+    const auto ceil_half = [](sindex_type val) { return val >= 0 ? (val + 1) / 2 : -((-val) / 2); };
+    const sindex_type begin = ceil_half(xbegin - xbase);
+    const sindex_type end = ceil_half(xend - xbase);
+    march_fused_range<ALPHA>(odd_plane, begin, end, false);
+}
+
+/**
+ * Advance the solution by the given number of time steps with temporal
+ * blocking.
+ *
+ * The update of the top SE of a CE only reads the two SEs next to it on the
+ * other plane, so a value at coordinate index j after half step h depends on
+ * j-1 and j+1 after half step h-1.  The coordinate range is cut into tiles,
+ * and the half steps are taken in two phases:
+ *
+ * 1. Every tile [lo, hi) is marched through all half steps over a shrinking
+ *    range [lo+h+1, hi-h-1) at half step h.  Only the values of the tile are
+ *    read, so the tiles are independent of each other.
+ * 2. The triangles left between the tiles, [b-h-1, b+h+1) at a tile border
+ *    b, are filled in the same order.  The range across the two ends of the
+ *    grid also treats the periodic boundary after each first half step.
+ *
+ * Each value is calculated exactly once and from the same inputs as
+ * march_half1_alpha() and march_half2_alpha(), and the solution is identical.
+ */
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_block_alpha(size_t steps)
+{
+    const Profiler::Scope timer(m_profiler, Profiler::BLOCK, steps * (2 * grid().ncelm() + 1));
+    const sindex_type nhalf = 2 * steps;
+    const sindex_type xbegin = Grid::BOUND_COUNT;
+    const sindex_type xend = grid().xsize() - Grid::BOUND_COUNT;
+    // A tile must hold both the shrinking range and the triangles.
+    const sindex_type min_width = 2 * nhalf + 2;
+    if (xend - xbegin < min_width)
+    {
+        for (size_t it=0; it<steps; ++it)
+        {
+            march_half_fused_alpha<ALPHA>(false);
+            march_half_fused_alpha<ALPHA>(true);
+        }
+        return;
+    }
+    size_t tile_ncelm = m_tile_ncelm;
+    if (0 == tile_ncelm)
+    {
+        // Fit the coordinate, so0, so1 and CFL of a tile in 256 kB.
+        tile_ncelm = (256 * 1024) / (2 * (2 + 2 * nvar()) * sizeof(value_type));
+    }
+    const sindex_type width = std::max(sindex_type(2 * tile_ncelm), min_width);
+    const sindex_type ntile = std::max(sindex_type(1), (xend - xbegin) / width);
+    // The last tile takes the remainder.
+    const auto border = [=](sindex_type it) { return it == ntile ? xend : xbegin + it * width; };
+
+    parallel_for(0, ntile, m_nthread, 1, [this, nhalf, &border](sindex_type it)
+    {
+        const sindex_type lo = border(it);
+        const sindex_type hi = border(it+1);
+        for (sindex_type ih=0; ih<nhalf; ++ih)
+        {
+            march_fused_xrange<ALPHA>(ih & 1, lo+ih+1, hi-ih-1);
+        }
+    });
+
+    parallel_for(0, ntile, m_nthread, 1, [this, nhalf, xbegin, xend, &border](sindex_type it)
+    {
+        if (0 == it)
+        {
+            for (sindex_type ih=0; ih<nhalf; ++ih)
+            {
+                const bool odd_plane = ih & 1;
+                march_fused_xrange<ALPHA>(odd_plane, xbegin, xbegin+ih+1);
+                march_fused_xrange<ALPHA>(odd_plane, xend-ih-1, xend);
+                if (!odd_plane)
+                {
+                    treat_boundary_so0();
+                    treat_boundary_so1();
+                    update_ghost_cfl();
+                }
+            }
+        }
+        else
+        {
+            const sindex_type bd = border(it);
+            for (sindex_type ih=0; ih<nhalf; ++ih)
+            {
+                march_fused_xrange<ALPHA>(ih & 1, bd-ih-1, bd+ih+1);
+            }
+        }
+    });
+
+    m_cfl_max = max_cfl(reduce_cfl_max(true, -1, grid().nselm()), reduce_cfl_max(false, 0, grid().nselm()));
 }
 
 template< typename ST, typename CE, typename SE >
 template< size_t ALPHA >
 inline void SolverBase<ST,CE,SE>::march_half1_alpha()
 {
+    if (m_use_fused) { march_half_fused_alpha<ALPHA>(false); return; }
     march_half_so0(false);
     treat_boundary_so0();
     update_cfl(true);
@@ -186,6 +519,7 @@ template< typename ST, typename CE, typename SE >
 template< size_t ALPHA >
 inline void SolverBase<ST,CE,SE>::march_half2_alpha()
 {
+    if (m_use_fused) { march_half_fused_alpha<ALPHA>(true); return; }
     // In the second half step, no treating boundary conditions.
     march_half_so0(true);
     update_cfl(false);
@@ -196,11 +530,441 @@ template< typename ST, typename CE, typename SE >
 template <size_t ALPHA>
 inline void SolverBase<ST,CE,SE>::march_alpha(size_t steps)
 {
+    march_output(steps, [this](size_t nstep) { this->template march_steps_alpha<ALPHA>(nstep); });
+}
+
+/**
+ * Call march(nstep) to advance steps in total, and push the field to the
+ * snapshot writer at the end of each output interval.
+ */
+template< typename ST, typename CE, typename SE >
+template< typename F >
+inline void SolverBase<ST,CE,SE>::march_output(size_t steps, F && march)
+{
+    if (!m_output)
+    {
+        march(steps);
+        return;
+    }
+    while (steps > 0)
+    {
+        const size_t nstep = std::min(steps, m_output_interval - m_step % m_output_interval);
+        march(nstep);
+        steps -= nstep;
+        if (0 == m_step % m_output_interval) { m_output->push(m_field, m_step); }
+    }
+}
+
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_steps_alpha(size_t steps)
+{
+    if (m_target_cfl > 0)
+    {
+        for (size_t it=0; it<steps; ++it)
+        {
+            march_half1_alpha<ALPHA>();
+            const value_type cfl_max1 = m_cfl_max;
+            march_half2_alpha<ALPHA>();
+            m_cfl_max = max_cfl(cfl_max1, m_cfl_max);
+            if (std::isfinite(m_cfl_max))
+            {
+                const value_type dt = m_field.time_increment();
+                value_type new_dt = dt * m_max_dt_growth;
+                if (m_cfl_max > 0) { new_dt = std::min(new_dt, dt * m_target_cfl / m_cfl_max); }
+                if (m_max_time_increment > 0) { new_dt = std::min(new_dt, m_max_time_increment); }
+                m_field.set_time_increment(new_dt);
+            }
+            ++m_step;
+        }
+        return;
+    }
+    if (m_block_steps > 1 && !m_field.kernel().has_plane_hook())
+    {
+        for (size_t it=0; it<steps; it+=m_block_steps)
+        {
+            march_block_alpha<ALPHA>(std::min(m_block_steps, steps-it));
+        }
+        m_step += steps;
+        return;
+    }
     for (size_t it=0; it<steps; ++it)
     {
         march_half1_alpha<ALPHA>();
         march_half2_alpha<ALPHA>();
     }
+    m_step += steps;
+}
+
+template< typename ST, typename CE, typename SE >
+inline void SolverBase<ST,CE,SE>::set_lts_coarse(std::vector<bool> const & coarse)
+{
+    const sindex_type ncelm = grid().ncelm();
+    if (coarse.size() != static_cast<size_t>(ncelm))
+    {
+        throw std::invalid_argument
+        (
+            Formatter() << "set_lts_coarse(): size " << coarse.size() << " != ncelm " << ncelm
+        );
+    }
+    for (auto & ranges : m_lts_ranges) { for (auto & plane : ranges) { plane.clear(); } }
+    m_lts_interface.clear();
+    const auto append = [](std::vector<range_type> & ranges, sindex_type ic)
+    {
+        if (!ranges.empty() && ranges.back().second == ic) { ++ranges.back().second; }
+        else { ranges.emplace_back(ic, ic+1); }
+    };
+    for (sindex_type ic=0; ic<ncelm; ++ic) { append(m_lts_ranges[coarse[ic]][0], ic); }
+    // CE ic on the odd plane updates SE ic+1 on the even plane, which is on an
+    // interface if the CEs on its two sides take different rates.  The SEs at
+    // the ends of the grid take the rate of the CE inside.
+    for (sindex_type ic=-1; ic<ncelm; ++ic)
+    {
+        const bool left = coarse[std::max(ic, sindex_type(0))];
+        const bool right = coarse[std::min(ic+1, ncelm-1)];
+        if (left == right) { append(m_lts_ranges[left][1], ic); }
+        else { m_lts_interface.push_back(ic+1); }
+    }
+    m_lts_coarse = coarse;
+}
+
+template< typename ST, typename CE, typename SE >
+inline std::vector<int> SolverBase<ST,CE,SE>::adapt_flags
+(
+    value_type refine, value_type coarsen, value_type min_width, value_type max_width
+) const
+{
+    const size_t ncelm = grid().ncelm();
+    const size_t nvar = m_field.nvar();
+    value_type const * x = grid().xcoord().data();
+    array_type const & so0 = m_field.so0();
+    array_type const & so1 = m_field.so1();
+    constexpr value_type tiny = std::numeric_limits<value_type>::min();
+    std::vector<value_type> range(nvar);
+    for (size_t iv=0; iv<nvar; ++iv)
+    {
+        value_type lo = std::numeric_limits<value_type>::infinity();
+        value_type hi = -lo;
+        for (size_t is=0; is<=ncelm; ++is)
+        {
+            const value_type val = so0(plane_xindex(false) + 2*is, iv);
+            lo = std::min(lo, val);
+            hi = std::max(hi, val);
+        }
+        range[iv] = hi - lo + tiny;
+    }
+    std::vector<int> ret(ncelm, 0);
+    for (size_t ic=0; ic<ncelm; ++ic)
+    {
+        const size_t ixn = plane_xindex(false) + 2*ic;
+        const size_t ixp = ixn + 2;
+        const value_type width = x[ixp] - x[ixn];
+        value_type variation = 0;
+        for (size_t iv=0; iv<nvar; ++iv)
+        {
+            const value_type slope = std::max(std::fabs(so1(ixn, iv)), std::fabs(so1(ixp, iv)));
+            variation = std::max(variation, width * slope / range[iv]);
+        }
+        if (variation > refine && width / 2 >= min_width) { ret[ic] = 1; }
+        else if (variation < coarsen && width * 2 <= max_width) { ret[ic] = -1; }
+    }
+    return ret;
+}
+
+template< typename ST, typename CE, typename SE >
+inline void SolverBase<ST,CE,SE>::remesh(std::shared_ptr<Grid> const & grid)
+{
+    if (grid->xmin() != this->grid().xmin() || grid->xmax() != this->grid().xmax())
+    {
+        throw std::invalid_argument
+        (
+            Formatter() << "remesh(): range [" << grid->xmin() << ", " << grid->xmax()
+                        << "] != [" << this->grid().xmin() << ", " << this->grid().xmax() << "]"
+        );
+    }
+    // The old field keeps the old grid alive.
+    Field const old(m_field);
+    const size_t nvar = m_field.nvar();
+    reset_grid(grid);
+
+    const value_type xmin = grid->xmin();
+    const value_type xmax = grid->xmax();
+    value_type const * ox = old.grid().xcoord().data();
+    value_type const * nx = grid->xcoord().data();
+    const size_t onselm = old.grid().nselm();
+    size_t io = 0;
+    for (size_t in=0; in<grid->nselm(); ++in)
+    {
+        const size_t inx = plane_xindex(false) + 2*in;
+        // Only the part of an SE inside the grid holds the solution.
+        const value_type lo = std::max(nx[inx-1], xmin);
+        const value_type hi = std::min(nx[inx+1], xmax);
+        const value_type ctr = (lo + hi) / 2;
+        const value_type len = hi - lo;
+        for (size_t iv=0; iv<nvar; ++iv)
+        {
+            value_type moment0 = 0;
+            value_type moment1 = 0;
+            for (size_t jo=io; jo<onselm; ++jo)
+            {
+                const size_t jox = plane_xindex(false) + 2*jo;
+                const value_type olo = std::max(ox[jox-1], lo);
+                const value_type ohi = std::min(ox[jox+1], hi);
+                if (olo >= hi) { break; }
+                if (ohi <= olo) { continue; }
+                // The old solution around the new center is a + b (x - ctr).
+                const value_type b = old.so1(jox, iv);
+                const value_type a = old.so0(jox, iv) + (ctr - (ox[jox-1] + ox[jox+1]) / 2) * b;
+                const value_type dlo = olo - ctr;
+                const value_type dhi = ohi - ctr;
+                moment0 += a * (dhi - dlo) + b * (dhi*dhi - dlo*dlo) / 2;
+                moment1 += a * (dhi*dhi - dlo*dlo) / 2 + b * (dhi*dhi*dhi - dlo*dlo*dlo) / 3;
+            }
+            const value_type so1 = 12 * moment1 / (len * len * len);
+            m_field.so1(inx, iv) = so1;
+            m_field.so0(inx, iv) = moment0 / len - (ctr - (nx[inx-1] + nx[inx+1]) / 2) * so1;
+        }
+        // The next new SE starts at or after the end of this one.
+        while (io+1 < onselm && ox[plane_xindex(false) + 2*io + 1] <= hi) { ++io; }
+    }
+    update_cfl(false);
+}
+
+/**
+ * Replace the grid with new solution arrays, and reset the rates of local time
+ * stepping.
+ */
+template< typename ST, typename CE, typename SE >
+inline void SolverBase<ST,CE,SE>::reset_grid(std::shared_ptr<Grid> const & grid)
+{
+    m_field.reset_grid(grid);
+    m_lts_coarse.clear();
+    for (auto & ranges : m_lts_ranges) { for (auto & plane : ranges) { plane.clear(); } }
+    m_lts_interface.clear();
+}
+
+template< typename ST, typename CE, typename SE >
+inline void SolverBase<ST,CE,SE>::read_checkpoint(std::string const & path)
+{
+    Checkpoint const ckpt(path);
+    Checkpoint::Header const & header = ckpt.header();
+    if (header.nvar != m_field.nvar())
+    {
+        throw std::invalid_argument
+        (
+            Formatter() << "read_checkpoint(): nvar " << header.nvar << " != " << m_field.nvar()
+        );
+    }
+    const size_t xsize = header.xsize;
+    const bool same_grid = xsize == grid().xsize()
+        && 0 == std::memcmp(ckpt.xcoord(), grid().xcoord().data(), xsize * sizeof(value_type));
+    if (!same_grid)
+    {
+        Grid::array_type xloc(std::vector<size_t>{static_cast<size_t>(header.ncelm) + 1});
+        for (size_t it=0; it<xloc.size(); ++it) { xloc[it] = ckpt.xcoord()[Grid::BOUND_COUNT + 2*it]; }
+        std::shared_ptr<Grid> ckpt_grid = Grid::construct(xloc);
+        if (grid().has_geometry()) { ckpt_grid->build_geometry(); }
+        reset_grid(ckpt_grid);
+    }
+    m_field.kernel().drop_plane();
+    std::memcpy(m_field.so0().data(), ckpt.so0(), xsize * m_field.nvar() * sizeof(value_type));
+    std::memcpy(m_field.so1().data(), ckpt.so1(), xsize * m_field.nvar() * sizeof(value_type));
+    std::memcpy(m_field.cfl().data(), ckpt.cfl(), xsize * sizeof(value_type));
+    m_field.set_time_increment(header.time_increment);
+    m_step = header.step;
+}
+
+/**
+ * March the CEs of one rate on the plane by the current time increment.
+ */
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_lts_ranges(bool coarse, bool odd_plane)
+{
+    for (range_type const & range : m_lts_ranges[coarse][odd_plane])
+    {
+        parallel_for_chunk(range.first, range.second, m_nthread, celm_align(), [this, odd_plane](sindex_type begin, sindex_type end)
+        {
+            march_fused_range<ALPHA>(odd_plane, begin, end, false);
+        });
+    }
+}
+
+/**
+ * Calculate the interface SE at the middle of the coarse step, from the CE
+ * between the interface and the center of the fine CE, over the second quarter
+ * of the coarse step.  Only the half of the SE on the fine side is used later,
+ * and its so0 is set so that the half holds the conserved amount of the CE.
+ * flux is the flux through the interface over the quarter, taken from the
+ * interface SE at the start of the step.  The time increment is the fine one.
+ */
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_lts_interface_half(sindex_type inode, value_type const * flux)
+{
+    const bool fine_left = m_lts_coarse[inode];
+    SE se = selm(inode, false);
+    SE const fine = selm(fine_left ? inode-1 : inode, true);
+    SE const coarse = selm(fine_left ? inode : inode-1, true);
+    const value_type width = fine_left ? se.dxneg() : se.dxpos();
+    const value_type xhalf = 0.5 * (se.x() + fine.x());
+    const value_type disp = xhalf - se.xctr();
+    for (size_t iv=0; iv<m_field.nvar(); ++iv)
+    {
+        const value_type amount = fine_left
+            ? fine.xp(iv) + fine.tp(iv) - flux[iv]
+            : fine.xn(iv) + flux[iv] - fine.tp(iv);
+        const value_type uhalf = amount / width;
+        // The coarse SE is already at the middle of the coarse step.
+        const value_type ufine = fine.so0p(iv);
+        const value_type ucoarse = coarse.so0(iv) + (coarse.x() - coarse.xctr()) * coarse.so1(iv);
+        const value_type duxf = (uhalf - ufine) / (xhalf - fine.x());
+        const value_type duxc = (ucoarse - uhalf) / (coarse.x() - xhalf);
+        se.so1(iv) = fine_left ? weigh_alpha<ALPHA>(duxf, duxc) : weigh_alpha<ALPHA>(duxc, duxf);
+        se.so0(iv) = uhalf - disp * se.so1(iv);
+    }
+}
+
+/**
+ * Calculate the interface SE at the end of the coarse step.  The CE covers the
+ * coarse side over the second half of the coarse step and the fine side over
+ * the last quarter, and exchanges flux with the fine CE below it through the
+ * interface over the third quarter.
+ */
+template< typename ST, typename CE, typename SE >
+template< size_t ALPHA >
+inline void SolverBase<ST,CE,SE>::march_lts_interface_full(sindex_type inode)
+{
+    const bool fine_left = m_lts_coarse[inode];
+    const size_t nvar = m_field.nvar();
+    const value_type dt = m_field.time_increment();
+    SE se = selm(inode, false);
+    SE const fine = selm(fine_left ? inode-1 : inode, true);
+    SE const coarse = selm(fine_left ? inode : inode-1, true);
+    std::vector<value_type> amount(nvar);
+    std::vector<value_type> ufine(nvar);
+    m_field.set_time_increment(dt / 2);
+    for (size_t iv=0; iv<nvar; ++iv)
+    {
+        amount[iv] = fine_left
+            ? fine.xp(iv) + fine.tp(iv) + se.tp(iv)
+            : fine.xn(iv) - fine.tp(iv) - se.tp(iv);
+        ufine[iv] = fine.so0p(iv);
+    }
+    m_field.set_time_increment(dt);
+    for (size_t iv=0; iv<nvar; ++iv)
+    {
+        amount[iv] += fine_left
+            ? coarse.xn(iv) - coarse.tp(iv)
+            : coarse.xp(iv) + coarse.tp(iv);
+        const value_type ucoarse = coarse.so0p(iv);
+        se.so0(iv) = amount[iv] / (se.xpos() - se.xneg());
+        const value_type duxf = (se.so0(iv) - ufine[iv]) / (se.x() - fine.x());
+        const value_type duxc = (ucoarse - se.so0(iv)) / (coarse.x() - se.x());
+        se.so1(iv) = fine_left ? weigh_alpha<ALPHA>(duxf, duxc) : weigh_alpha<ALPHA>(duxc, duxf);
+    }
+    // The narrower half of the SE is on the fine side.
+    m_field.set_time_increment(dt / 2);
+    se.update_cfl();
+    m_field.set_time_increment(dt);
+}
+
+/**
+ * Advance the solution by the given number of coarse steps with local time
+ * stepping.  Every CE marches by the scheme of its rate, and the SE on an
+ * interface between the rates is calculated by two special CEs, so that all
+ * the CEs of a coarse step tile the space-time region without overlap.  The
+ * flux through every CE boundary is evaluated once and used by the CEs on its
+ * two sides, and the solution is conserved across the interfaces.
+ *
+ * Take the fine CEs on the left of an interface SE k at x_k for example, with
+ * the coarse step from t to t+dt:
+ *
+ * 1. The coarse CE [x_k, x_{k+1}] marches from t to t+dt/2, and the fine CE
+ *    [x_{k-1}, x_k] from t to t+dt/4.
+ * 2. The fine side of SE k at t+dt/2 is calculated from the region
+ *    [x_{k-1/2}, x_k] over [t+dt/4, t+dt/2].  The flux through x_k over the
+ *    quarter is that of the coarse CE minus that of the fine CE.
+ * 3. The fine CEs march to t+dt, and the coarse CEs next to the interface to
+ *    t+dt.
+ * 4. SE k at t+dt is calculated from the staircase of [x_{k-1/2}, x_k] over
+ *    [t+3dt/4, t+dt] and [x_k, x_{k+1/2}] over [t+dt/2, t+dt].
+ *
+ * With all CEs of one rate the marching is the same as march_alpha() with
+ * march_half_fused_alpha().  Plane hooks of Kernel are not supported.
+ */
+template< typename ST, typename CE, typename SE >
+template <size_t ALPHA>
+inline void SolverBase<ST,CE,SE>::march_lts_alpha(size_t steps)
+{
+    march_output(steps, [this](size_t nstep) { this->template march_lts_steps_alpha<ALPHA>(nstep); });
+}
+
+template< typename ST, typename CE, typename SE >
+template <size_t ALPHA>
+inline void SolverBase<ST,CE,SE>::march_lts_steps_alpha(size_t steps)
+{
+    const sindex_type ncelm = grid().ncelm();
+    if (m_lts_coarse.size() != static_cast<size_t>(ncelm))
+    {
+        throw std::runtime_error("march_lts_alpha(): set_lts_coarse() is not called for the grid");
+    }
+    if (m_field.kernel().has_plane_hook())
+    {
+        throw std::runtime_error("march_lts_alpha(): plane hooks of Kernel are not supported");
+    }
+    const bool periodic = Boundary::PERIODIC == m_left_boundary.type()
+                       || Boundary::PERIODIC == m_right_boundary.type();
+    if (periodic && m_lts_coarse.front() != m_lts_coarse.back())
+    {
+        throw std::runtime_error("march_lts_alpha(): the two ends of a periodic grid take different rates");
+    }
+    // Counted as if all CEs were coarse.
+    const Profiler::Scope timer(m_profiler, Profiler::LTS, steps * (2 * ncelm + 1));
+    const bool coarse_end = m_lts_coarse.front() || m_lts_coarse.back();
+    const bool fine_end = !m_lts_coarse.front() || !m_lts_coarse.back();
+    const auto treat_boundary = [this]()
+    {
+        treat_boundary_so0();
+        treat_boundary_so1();
+        update_ghost_cfl();
+    };
+    const size_t nvar = m_field.nvar();
+    const value_type dt = m_field.time_increment();
+    std::vector<value_type> flux(m_lts_interface.size() * nvar);
+    for (size_t it=0; it<steps; ++it)
+    {
+        m_field.set_time_increment(dt / 2);
+        for (size_t ii=0; ii<m_lts_interface.size(); ++ii)
+        {
+            SE const se = selm(m_lts_interface[ii], false);
+            for (size_t iv=0; iv<nvar; ++iv) { flux[ii*nvar+iv] = -se.tp(iv); }
+        }
+        m_field.set_time_increment(dt);
+        for (size_t ii=0; ii<m_lts_interface.size(); ++ii)
+        {
+            SE const se = selm(m_lts_interface[ii], false);
+            for (size_t iv=0; iv<nvar; ++iv) { flux[ii*nvar+iv] += se.tp(iv); }
+        }
+        march_lts_ranges<ALPHA>(true, false);
+        if (coarse_end) { treat_boundary(); }
+        m_field.set_time_increment(dt / 2);
+        march_lts_ranges<ALPHA>(false, false);
+        if (fine_end) { treat_boundary(); }
+        march_lts_ranges<ALPHA>(false, true);
+        for (size_t ii=0; ii<m_lts_interface.size(); ++ii)
+        {
+            march_lts_interface_half<ALPHA>(m_lts_interface[ii], flux.data() + ii*nvar);
+        }
+        march_lts_ranges<ALPHA>(false, false);
+        if (fine_end) { treat_boundary(); }
+        march_lts_ranges<ALPHA>(false, true);
+        m_field.set_time_increment(dt);
+        march_lts_ranges<ALPHA>(true, true);
+        for (sindex_type inode : m_lts_interface) { march_lts_interface_full<ALPHA>(inode); }
+    }
+    m_step += steps;
+    m_cfl_max = max_cfl(reduce_cfl_max(true, -1, grid().nselm()), reduce_cfl_max(false, 0, grid().nselm()));
 }
 
 } /* end namespace spacetime */
@@ -5,18 +5,33 @@
  * BSD 3-Clause License, see COPYING
  */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "spacetime/system.hpp"
 #include "spacetime/type.hpp"
+#include "spacetime/math.hpp"
 #include "spacetime/Grid_decl.hpp"
 #include "spacetime/Field_decl.hpp"
+#include "spacetime/Boundary.hpp"
+#include "spacetime/Checkpoint.hpp"
+#include "spacetime/Snapshot.hpp"
+#include "spacetime/Profile.hpp"
+#include "spacetime/parallel.hpp"
+#include "spacetime/Sweep.hpp"
 
 namespace spacetime
 {
 
 class Selm;
+template< typename ST > class DistributedSolver;
 
 /**
  * Algorithmic definition for solution.  It holds the type information for the
@@ -56,6 +71,9 @@ public:
             std::shared_ptr<Grid> new_grid = m_field.clone_grid();
             ret->m_field.set_grid(new_grid);
         }
+        // A snapshot writer takes a single producer.
+        ret->m_output.reset();
+        ret->m_output_interval = 0;
         return ret;
     }
 
@@ -84,11 +102,15 @@ public:
 #define DECL_ST_ARRAY_ACCESS_0D(NAME) \
     array_type const & NAME() const { return m_field.NAME(); } \
     array_type       & NAME()       { return m_field.NAME(); } \
+    std::shared_ptr<array_type const> shared_ ## NAME() const { return m_field.shared_ ## NAME(); } \
+    std::shared_ptr<array_type      > shared_ ## NAME()       { return m_field.shared_ ## NAME(); } \
     array_type get_ ## NAME(bool odd_plane) const; \
     void set_ ## NAME(array_type const & arr, bool odd_plane);
 #define DECL_ST_ARRAY_ACCESS_1D(NAME) \
     array_type const & NAME() const { return m_field.NAME(); } \
     array_type       & NAME()       { return m_field.NAME(); } \
+    std::shared_ptr<array_type const> shared_ ## NAME() const { return m_field.shared_ ## NAME(); } \
+    std::shared_ptr<array_type      > shared_ ## NAME()       { return m_field.shared_ ## NAME(); } \
     array_type get_ ## NAME(size_t iv, bool odd_plane) const; \
     void set_ ## NAME(size_t iv, array_type const & arr, bool odd_plane);
 
@@ -101,6 +123,28 @@ public:
 
     array_type get_so0p(size_t iv, bool odd_plane) const;
 
+    /**
+     * Coordinate index of SE 0 on the plane for get_so0() and the other
+     * getters.  The following SEs are every two coordinates.
+     */
+    static size_t plane_xindex(bool odd_plane) { return Grid::BOUND_COUNT + (odd_plane ? 1 : 0); }
+    /**
+     * Number of SEs on the plane for get_so0() and the other getters.
+     */
+    size_t plane_nselm(bool odd_plane) const { return grid().nselm() - (odd_plane ? 1 : 0); }
+
+    /**
+     * Copy a strided buffer into the SEs on the plane in one pass.  Row it of
+     * the source, at data + it*row_stride, goes to SE it, and the element
+     * jv*col_stride after the row start goes to variable ivbegin+jv, for
+     * nv variables.  Strides are in elements.  dst is so0(), so1() or cfl().
+     */
+    void import_plane
+    (
+        array_type & dst, value_type const * data, sindex_type row_stride, sindex_type col_stride
+      , size_t ivbegin, size_t nv, bool odd_plane
+    );
+
     size_t nvar() const { return m_field.nvar(); }
 
     void set_time_increment(value_type time_increment) { m_field.set_time_increment(time_increment); }
@@ -127,20 +171,263 @@ public:
     SE const selm_at(sindex_type ielm, bool odd_plane) const { return m_field.selm_at<SE>(ielm, odd_plane); }
     SE       selm_at(sindex_type ielm, bool odd_plane)       { return m_field.selm_at<SE>(ielm, odd_plane); }
 
+    /**
+     * Number of threads used by the marching loops.  Threading takes effect
+     * only when built with OpenMP.  The kernel must be thread-safe.
+     */
+    size_t nthread() const { return m_nthread; }
+    void set_nthread(size_t nthread) { m_nthread = std::max(size_t(1), nthread); }
+
+    /**
+     * Reallocate the solution arrays, first touched by the threads marching
+     * them, so that with the first-touch NUMA policy a thread marches memory
+     * on its own node.  With huge_pages the new arrays are advised for
+     * transparent huge pages.  Call it after set_nthread(), and again after
+     * remesh() or adapt().  Raw pointers to the old arrays become invalid;
+     * the element proxies index the field and stay valid, and the Python
+     * views and arrays keep the old arrays and stop following the solution.
+     * The grid is left alone, because other solvers and the element proxies
+     * hold pointers to its coordinates; place it with Grid::place_memory()
+     * before creating the solvers.  See memory.hpp.
+     */
+    void place_memory(bool huge_pages=true)
+    {
+        m_field.place_memory(m_nthread, celm_align(), huge_pages);
+    }
+
+    /**
+     * Whether the solver provides an element-free sweep (see Sweep.hpp).
+     */
+    static constexpr bool has_sweep() { return detail::sweep_of<ST>::value; }
+    bool use_sweep() const { return m_use_sweep; }
+    /**
+     * Select marching by the sweep instead of the CE/SE proxies.
+     */
+    void set_use_sweep(bool use_sweep)
+    {
+        if (use_sweep && !has_sweep())
+        {
+            throw std::invalid_argument("set_use_sweep(): the solver does not provide a sweep");
+        }
+        m_use_sweep = use_sweep;
+    }
+
+    /**
+     * Select marching the half steps by march_half_fused_alpha().
+     */
+    bool use_fused() const { return m_use_fused; }
+    void set_use_fused(bool use_fused) { m_use_fused = use_fused; }
+
+    /**
+     * Number of time steps march_alpha() advances a tile of the grid before
+     * moving to the next tile.  1 turns off temporal blocking.  Blocking is
+     * skipped when a plane hook of Kernel is set.
+     */
+    size_t block_steps() const { return m_block_steps; }
+    void set_block_steps(size_t block_steps) { m_block_steps = std::max(size_t(1), block_steps); }
+    /**
+     * Number of CEs in a tile for temporal blocking.  0 sizes the tile to
+     * the cache.  The tile is widened to at least 2*block_steps()+1 CEs.
+     */
+    size_t tile_ncelm() const { return m_tile_ncelm; }
+    void set_tile_ncelm(size_t tile_ncelm) { m_tile_ncelm = tile_ncelm; }
+
+    /**
+     * Boundary conditions at the two ends of the grid, applied by
+     * treat_boundary_so0() and treat_boundary_so1() for all variables.
+     * Both are periodic by default.
+     */
+    Boundary const & left_boundary() const { return m_left_boundary; }
+    Boundary const & right_boundary() const { return m_right_boundary; }
+    void set_left_boundary(Boundary const & bnd) { bnd.validate(nvar()); m_left_boundary = bnd; }
+    void set_right_boundary(Boundary const & bnd) { bnd.validate(nvar()); m_right_boundary = bnd; }
+
+    /**
+     * Maximum CFL number of the last update.  update_cfl() and the fused
+     * half step take it over the plane, march_alpha() with adaptive time
+     * stepping over both half steps, and temporally blocked marching over
+     * both planes at the end of a block.
+     */
+    value_type cfl_max() const { return m_cfl_max; }
+    /**
+     * Target CFL number for adaptive time stepping.  When positive,
+     * march_alpha() scales the time increment after each step so that the
+     * maximum CFL number of the step becomes the target, and temporal
+     * blocking is not used.  0 keeps the time increment fixed.  The time
+     * increment grows by at most max_dt_growth() in a step, and not beyond
+     * max_time_increment() if positive, so that a flow starting almost at
+     * rest does not take a huge step.  A step whose maximum CFL number
+     * overshoots the target, even beyond 1, is accepted and not redone; the
+     * next step is shortened by it.
+     */
+    value_type target_cfl() const { return m_target_cfl; }
+    void set_target_cfl(value_type target_cfl) { m_target_cfl = target_cfl; }
+    value_type max_dt_growth() const { return m_max_dt_growth; }
+    void set_max_dt_growth(value_type max_dt_growth)
+    {
+        if (!(max_dt_growth >= 1))
+        {
+            throw std::invalid_argument(Formatter() << "set_max_dt_growth(): " << max_dt_growth << " < 1");
+        }
+        m_max_dt_growth = max_dt_growth;
+    }
+    value_type max_time_increment() const { return m_max_time_increment; }
+    void set_max_time_increment(value_type max_time_increment) { m_max_time_increment = max_time_increment; }
+
+    /**
+     * Rates of local time stepping, one flag for each CE on the even plane.
+     * In a step of march_lts_alpha(), a coarse CE marches one time step of
+     * time_increment() and a fine CE two time steps of a half of it.
+     */
+    std::vector<bool> const & lts_coarse() const { return m_lts_coarse; }
+    void set_lts_coarse(std::vector<bool> const & coarse);
+
+    /**
+     * Flags for Grid::adapt() from the variation of the solution over each CE
+     * on the even plane, the width times the larger |so1| of its two SEs,
+     * relative to the range of so0 over the grid and maximized over the
+     * variables.  A CE is flagged 1 if the variation is above refine and a
+     * half of the CE is not narrower than min_width, and -1 if the variation
+     * is below coarsen and twice the CE is not wider than max_width.
+     */
+    std::vector<int> adapt_flags
+    (
+        value_type refine, value_type coarsen
+      , value_type min_width = 0, value_type max_width = std::numeric_limits<value_type>::infinity()
+    ) const;
+    /**
+     * Move the solution to a grid over the same range.  so0 and so1 of the
+     * SEs on the even plane are projected from the piecewise linear solution,
+     * so that the integral and the first moment over each SE are preserved.
+     * The CFL numbers are updated, and the rates of local time stepping are
+     * reset.  The solution must be at a full time step.
+     */
+    void remesh(std::shared_ptr<Grid> const & grid);
+    void adapt(std::vector<int> const & flags) { remesh(grid().adapt(flags)); }
+
+    /**
+     * Number of time steps marched by march_alpha() and march_lts_alpha().
+     */
+    size_t step() const { return m_step; }
+    void set_step(size_t step) { m_step = step; }
+
+    /**
+     * Write the grid, so0, so1, cfl, time increment and step to a binary
+     * checkpoint file (see Checkpoint.hpp).
+     */
+    void write_checkpoint(std::string const & path) const { Checkpoint::write(path, m_field, m_step); }
+    /**
+     * Restore the solver from a checkpoint file.  The grid is replaced if
+     * the coordinates differ, and the rates of local time stepping are reset
+     * then.
+     */
+    void read_checkpoint(std::string const & path);
+
+    /**
+     * Snapshot writer that march_alpha() and march_lts_alpha() push the
+     * field to whenever step() reaches a multiple of interval.  Marching is
+     * split at these steps, so that temporal blocking does not go past them.
+     * A null writer turns off the output.
+     */
+    std::shared_ptr<SnapshotWriter> const & output() const { return m_output; }
+    size_t output_interval() const { return m_output_interval; }
+    void set_output(std::shared_ptr<SnapshotWriter> output, size_t interval)
+    {
+        if (output && 0 == interval)
+        {
+            throw std::invalid_argument("set_output(): interval must be positive");
+        }
+        m_output = std::move(output);
+        m_output_interval = m_output ? interval : 0;
+    }
+    /**
+     * Write the queued snapshots and drop the writer.
+     */
+    void close_output()
+    {
+        std::shared_ptr<SnapshotWriter> output = std::move(m_output);
+        m_output_interval = 0;
+        if (output) { output->close(); }
+    }
+
+    /**
+     * Wall time, calls and elements of the marching phases (see
+     * Profile.hpp).  The records stay zero unless built with
+     * SPACETIME_PROFILE.
+     */
+    Profiler const & profiler() const { return m_profiler; }
+    void reset_profiler() { m_profiler.reset(); }
+
     void update_cfl(bool odd_plane);
     void march_half_so0(bool odd_plane);
     template <size_t ALPHA> void march_half_so1_alpha(bool odd_plane);
     void treat_boundary_so0();
     void treat_boundary_so1();
+    template <size_t ALPHA> void march_half_fused_alpha(bool odd_plane);
 
     void setup_march() { update_cfl(false); }
     template <size_t ALPHA> void march_half1_alpha();
     template <size_t ALPHA> void march_half2_alpha();
     template <size_t ALPHA> void march_alpha(size_t steps);
+    template <size_t ALPHA> void march_lts_alpha(size_t steps);
 
 private:
 
+    // Marches the local solver of a rank by the private half-step pieces.
+    template< typename > friend class DistributedSolver;
+
+    /**
+     * Number of CEs per cache line of so0/so1.
+     */
+    size_t celm_align() const { return cache_line_align(2 * nvar() * sizeof(value_type)); }
+
+    template <size_t ALPHA> void march_fused_range(bool odd_plane, sindex_type begin, sindex_type end, bool plane_cfl);
+    template <size_t ALPHA> void march_fused_xrange(bool odd_plane, sindex_type xbegin, sindex_type xend);
+    void update_ghost_cfl();
+    value_type scan_cfl_max(bool odd_plane, sindex_type begin, sindex_type end) const;
+    value_type reduce_cfl_max(bool odd_plane, sindex_type start, sindex_type stop) const;
+    static value_type max_cfl(value_type lhs, value_type rhs) { return (lhs >= rhs || std::isnan(lhs)) ? lhs : rhs; }
+    template <size_t ALPHA> void march_block_alpha(size_t steps);
+    template <size_t ALPHA> void march_steps_alpha(size_t steps);
+    template <size_t ALPHA> void march_lts_steps_alpha(size_t steps);
+    template <typename F> void march_output(size_t steps, F && march);
+
+    void reset_grid(std::shared_ptr<Grid> const & grid);
+
+    using range_type = std::pair<sindex_type, sindex_type>;
+    template <size_t ALPHA> void march_lts_ranges(bool coarse, bool odd_plane);
+    template <size_t ALPHA> void march_lts_interface_half(sindex_type inode, value_type const * flux);
+    template <size_t ALPHA> void march_lts_interface_full(sindex_type inode);
+    template <size_t ALPHA> static value_type weigh_alpha(value_type duxn, value_type duxp)
+    {
+        const value_type fan = pow<ALPHA>(std::fabs(duxn));
+        const value_type fap = pow<ALPHA>(std::fabs(duxp));
+        constexpr value_type tiny = std::numeric_limits<value_type>::min();
+        return (fap*duxn + fan*duxp) / (fap + fan + tiny);
+    }
+
     Field m_field;
+    Boundary m_left_boundary;
+    Boundary m_right_boundary;
+    size_t m_nthread = 1;
+    bool m_use_sweep = false;
+    bool m_use_fused = false;
+    size_t m_block_steps = 1;
+    size_t m_tile_ncelm = 0;
+    value_type m_cfl_max = 0;
+    value_type m_target_cfl = 0;
+    value_type m_max_dt_growth = 1.2;
+    value_type m_max_time_increment = 0;
+    size_t m_step = 0;
+    std::shared_ptr<SnapshotWriter> m_output;
+    size_t m_output_interval = 0;
+    Profiler m_profiler;
+    std::vector<bool> m_lts_coarse;
+    // CE ranges of the fine ([0]) and coarse ([1]) rates on the even ([0])
+    // and odd ([1]) planes.
+    std::vector<range_type> m_lts_ranges[2][2];
+    // Even-plane SEs between a fine and a coarse CE.
+    std::vector<sindex_type> m_lts_interface;
 
 }; /* end class SolverBase */
 
@@ -0,0 +1,329 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Element-free marching sweeps for scalar equations.
+ *
+ * The sweeps work directly on the contiguous coordinate and solution arrays
+ * instead of constructing Celm/Selm proxies, so that the loops over CEs can
+ * be vectorized.  The arithmetic follows the proxy path operation by
+ * operation, and the results are identical unless the geometry cache of the
+ * Grid is used.
+ *
+ * The flux type FT supplies the parts depending on the equation, templated on
+ * the arithmetic type A:
+ *
+ *   // Temporal flux of an SE before multiplied by hdt.  sqdt is -qdt for
+ *   // the tp branch and qdt for the tn branch.
+ *   template< typename A > static A tflux(A u, A ux, A disp, A sqdt);
+ *   // CFL number with hdx = min(dxneg, dxpos).
+ *   template< typename A > static A cfl(A u, A hdt, A hdx);
+ *
+ * The calc_*() functions read the solution stored in type T and calculate in
+ * the type of the time increment A, so that EnsembleSolver may store float
+ * and calculate in float or double.  The geometry is double and converted to
+ * A.  With T and A being double (Field), nothing is converted.
+ *
+ * The march_*() and update_cfl() functions take Field or BasicField, and
+ * calculate in the type of its half time increment.
+ *
+ * The geometry of the elements is calculated from the coordinates
+ * (CoordGeometry), or read from the cache of the Grid (Grid::Geometry) after
+ * Grid::build_geometry() is called.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/math.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/Field_decl.hpp"
+
+#ifdef _OPENMP
+#define SPACETIME_PRAGMA_SIMD _Pragma("omp simd")
+#else
+#define SPACETIME_PRAGMA_SIMD
+#endif
+
+namespace spacetime
+{
+
+namespace detail
+{
+
+template< typename ... Ts > struct make_void { using type = void; };
+
+/**
+ * Sweep used by solvers not providing one.  Never invoked.
+ */
+struct NullSweep
+{
+    static void march_so0(Field & /*field*/, bool /*odd_plane*/, sindex_type /*begin*/, sindex_type /*end*/) {}
+    template< size_t ALPHA >
+    static void march_so1_alpha(Field & /*field*/, bool /*odd_plane*/, sindex_type /*begin*/, sindex_type /*end*/) {}
+    static void update_cfl(Field & /*field*/, bool /*odd_plane*/, sindex_type /*begin*/, sindex_type /*end*/) {}
+    template< size_t ALPHA >
+    static void march_fused_alpha(Field & /*field*/, bool /*odd_plane*/, sindex_type /*begin*/, sindex_type /*end*/) {}
+};
+
+template< typename ST, typename = void >
+struct sweep_of : std::false_type { using type = NullSweep; };
+
+/**
+ * A solver provides its sweep by the member type sweep_type.
+ */
+template< typename ST >
+struct sweep_of<ST, typename make_void<typename ST::sweep_type>::type> : std::true_type
+{
+    using type = typename ST::sweep_type;
+};
+
+} /* end namespace detail */
+
+/**
+ * Geometry of the elements calculated from the coordinates on the fly, with
+ * the same interface as Grid::Geometry.
+ */
+struct CoordGeometry
+{
+
+    using value_type = Grid::value_type;
+
+    value_type xctr(size_t i) const { return (x[i-1] + x[i+1]) / 2; }
+    value_type disp(size_t i) const { return x[i] - xctr(i); }
+    value_type dispneg(size_t i) const { return 0.5 * (x[i] + x[i-1]) - xctr(i); }
+    value_type disppos(size_t i) const { return 0.5 * (x[i] + x[i+1]) - xctr(i); }
+    value_type dxneg(size_t i) const { return x[i] - x[i-1]; }
+    value_type dxpos(size_t i) const { return x[i+1] - x[i]; }
+    value_type hdx(size_t i) const { return std::min(dxneg(i), dxpos(i)); }
+    template< typename A > A div_dx(A val, size_t i) const { return val / static_cast<A>(x[i+1] - x[i-1]); }
+    template< typename A > A div_dxpos(A val, size_t i) const { return val / static_cast<A>(dxpos(i)); }
+
+    value_type const * x;
+
+}; /* end struct CoordGeometry */
+
+/**
+ * Call body with the geometry cache of the grid if built, or with the
+ * geometry from the coordinates.
+ */
+template< typename F >
+inline void with_geometry(Grid const & grid, F && body)
+{
+    if (grid.has_geometry()) { body(grid.geometry()); }
+    else { body(CoordGeometry{grid.xcoord().data()}); }
+}
+
+template< typename FT >
+struct ScalarSweep
+{
+
+    using value_type = Field::value_type;
+
+    /**
+     * Coordinate index of the CE of index ic on the plane.
+     */
+    static size_t xindex_celm(sindex_type ic, bool odd_plane)
+    {
+        return 1 + Grid::BOUND_COUNT + (ic << 1) + (odd_plane ? 1 : 0);
+    }
+
+    /**
+     * Coordinate index of the SE of index is on the plane.
+     */
+    static size_t xindex_selm(sindex_type is, bool odd_plane)
+    {
+        return Grid::BOUND_COUNT + (is << 1) + (odd_plane ? 1 : 0);
+    }
+
+    /**
+     * Calculate so0 of the top SEs of the CEs [begin, end) on the plane.
+     */
+    template< typename FD >
+    static void march_so0(FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom) { march_so0(geom, field, odd_plane, begin, end); });
+    }
+
+    template< typename G, typename FD >
+    static void march_so0(G const geom, FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        if (end <= begin) { return; }
+        typename FD::value_type * u = field.so0().data();
+        typename FD::value_type const * ux = field.so1().data();
+        const auto hdt = field.hdt();
+        const auto qdt = field.qdt();
+        const size_t xbegin = xindex_celm(begin, odd_plane);
+        const sindex_type nelm = end - begin;
+        SPACETIME_PRAGMA_SIMD
+        for (sindex_type it=0; it<nelm; ++it)
+        {
+            const size_t ic = xbegin + (it << 1);
+            u[ic] = calc_so0(geom, u, ux, hdt, qdt, ic);
+        }
+    }
+
+    /**
+     * Calculate so1 of the top SEs of the CEs [begin, end) on the plane.
+     */
+    template< size_t ALPHA, typename FD >
+    static void march_so1_alpha(FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom) { march_so1_alpha<ALPHA>(geom, field, odd_plane, begin, end); });
+    }
+
+    template< size_t ALPHA, typename G, typename FD >
+    static void march_so1_alpha(G const geom, FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        if (end <= begin) { return; }
+        typename FD::value_type const * u = field.so0().data();
+        typename FD::value_type * ux = field.so1().data();
+        const auto hdt = field.hdt();
+        const size_t xbegin = xindex_celm(begin, odd_plane);
+        const sindex_type nelm = end - begin;
+        SPACETIME_PRAGMA_SIMD
+        for (sindex_type it=0; it<nelm; ++it)
+        {
+            const size_t ic = xbegin + (it << 1);
+            ux[ic] = calc_so1_alpha<ALPHA>(geom, u, ux, hdt, ic);
+        }
+    }
+
+    /**
+     * Update the CFL numbers of the SEs [begin, end) on the plane.
+     */
+    template< typename FD >
+    static void update_cfl(FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom) { update_cfl(geom, field, odd_plane, begin, end); });
+    }
+
+    template< typename G, typename FD >
+    static void update_cfl(G const geom, FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        if (end <= begin) { return; }
+        typename FD::value_type const * u = field.so0().data();
+        typename FD::value_type * cfl = field.cfl().data();
+        const auto hdt = field.hdt();
+        const size_t xbegin = xindex_selm(begin, odd_plane);
+        const sindex_type nelm = end - begin;
+        SPACETIME_PRAGMA_SIMD
+        for (sindex_type it=0; it<nelm; ++it)
+        {
+            const size_t is = xbegin + (it << 1);
+            cfl[is] = calc_cfl(geom, u, hdt, is);
+        }
+    }
+
+    /**
+     * Calculate so0, CFL and so1 of the top SEs of the CEs [begin, end) on
+     * the plane in one pass.  The so1 of a CE only reads the so0 of its own
+     * top SE from the new plane, so the three updates need no lag.
+     */
+    template< size_t ALPHA, typename FD >
+    static void march_fused_alpha(FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom) { march_fused_alpha<ALPHA>(geom, field, odd_plane, begin, end); });
+    }
+
+    template< size_t ALPHA, typename G, typename FD >
+    static void march_fused_alpha(G const geom, FD & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        if (end <= begin) { return; }
+        typename FD::value_type * u = field.so0().data();
+        typename FD::value_type * ux = field.so1().data();
+        typename FD::value_type * cfl = field.cfl().data();
+        const auto hdt = field.hdt();
+        const auto qdt = field.qdt();
+        const size_t xbegin = xindex_celm(begin, odd_plane);
+        const sindex_type nelm = end - begin;
+        SPACETIME_PRAGMA_SIMD
+        for (sindex_type it=0; it<nelm; ++it)
+        {
+            const size_t ic = xbegin + (it << 1);
+            u[ic] = calc_so0(geom, u, ux, hdt, qdt, ic);
+            cfl[ic] = calc_cfl(geom, u, hdt, ic);
+            ux[ic] = calc_so1_alpha<ALPHA>(geom, u, ux, hdt, ic);
+        }
+    }
+
+    /**
+     * so0 of the top SE of the CE at coordinate index ic.  The top SE shares
+     * the coordinate index of the CE.  The solution of coordinate index i is
+     * at u[i*stride], so that interleaved problems sharing the coordinates
+     * can be marched (see Ensemble.hpp).
+     */
+    template< typename G, typename T, typename A >
+    static T calc_so0
+    (
+        G const & geom, T const * u, T const * ux
+      , A hdt, A qdt, size_t ic, size_t stride=1
+    )
+    {
+        const size_t in = ic - 1;
+        const size_t ip = ic + 1;
+        const A un = u[in*stride];
+        const A uxn = ux[in*stride];
+        const A up = u[ip*stride];
+        const A uxp = ux[ip*stride];
+        // Left SE: xp + tp.
+        const A nxp = static_cast<A>(geom.dxpos(in)) * (un + static_cast<A>(geom.disppos(in)) * uxn);
+        const A ntp = hdt * FT::tflux(un, uxn, static_cast<A>(geom.disp(in)), -qdt);
+        // Right SE: xn - tp.
+        const A pxn = static_cast<A>(geom.dxneg(ip)) * (up + static_cast<A>(geom.dispneg(ip)) * uxp);
+        const A ptp = hdt * FT::tflux(up, uxp, static_cast<A>(geom.disp(ip)), -qdt);
+        const A flux_ll = nxp + ntp;
+        const A flux_ur = pxn - ptp;
+        return static_cast<T>(geom.div_dx(flux_ll + flux_ur, ic));
+    }
+
+    /**
+     * so1 of the top SE of the CE at coordinate index ic, from the updated
+     * so0 of the top SE.
+     */
+    template< size_t ALPHA, typename G, typename T, typename A >
+    static T calc_so1_alpha
+    (
+        G const & geom, T const * u, T const * ux
+      , A hdt, size_t ic, size_t stride=1
+    )
+    {
+        constexpr A tiny = std::numeric_limits<A>::min();
+        const size_t in = ic - 1;
+        const size_t ip = ic + 1;
+        A upn = u[in*stride];
+        upn += static_cast<A>(geom.disp(in)) * ux[in*stride];
+        upn -= hdt * ux[in*stride];
+        A upp = u[ip*stride];
+        upp += static_cast<A>(geom.disp(ip)) * ux[ip*stride];
+        upp -= hdt * ux[ip*stride];
+        const A utp = u[ic*stride];
+        const A duxn = geom.div_dxpos(utp - upn, in);
+        const A duxp = geom.div_dxpos(upp - utp, ic);
+        const A fan = pow<ALPHA>(std::fabs(duxn));
+        const A fap = pow<ALPHA>(std::fabs(duxp));
+        return static_cast<T>((fap*duxn + fan*duxp) / (fap + fan + tiny));
+    }
+
+    /**
+     * CFL number of the SE at coordinate index is.
+     */
+    template< typename G, typename T, typename A >
+    static T calc_cfl(G const & geom, T const * u, A hdt, size_t is, size_t stride=1)
+    {
+        return static_cast<T>(FT::cfl(static_cast<A>(u[is*stride]), hdt, static_cast<A>(geom.hdx(is))));
+    }
+
+}; /* end struct ScalarSweep */
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
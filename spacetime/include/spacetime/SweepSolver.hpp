@@ -0,0 +1,275 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Solver of a scalar equation marched by ScalarSweep on a BasicField.
+ *
+ * The solver takes no kernel and creates no element proxies, so that the
+ * solution may be stored in float (T) to halve the memory traffic and double
+ * the number of CEs per vector instruction.  The arithmetic is done in A,
+ * which defaults to T.  The grid and the time increment stay double.  With T
+ * and A being double it marches to the same solution as the SolverBase sweep.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/BasicField.hpp"
+#include "spacetime/Boundary.hpp"
+#include "spacetime/parallel.hpp"
+#include "spacetime/memory.hpp"
+#include "spacetime/Sweep.hpp"
+
+namespace spacetime
+{
+
+template< typename FT, typename T = Grid::value_type, typename A = T >
+class SweepSolver
+  : public std::enable_shared_from_this<SweepSolver<FT, T, A>>
+{
+
+private:
+
+    class ctor_passkey {};
+
+public:
+
+    using value_type = T;
+    using calc_type = A;
+    using field_type = BasicField<T, A>;
+    using array_type = typename field_type::array_type;
+    using flux_type = FT;
+    using sweep_type = ScalarSweep<FT>;
+
+    static std::shared_ptr<SweepSolver>
+    construct(std::shared_ptr<Grid> const & grid, real_type time_increment)
+    {
+        return std::make_shared<SweepSolver>(grid, time_increment, ctor_passkey());
+    }
+
+    std::shared_ptr<SweepSolver> clone(bool grid=false) const
+    {
+        auto ret = std::make_shared<SweepSolver>(*this);
+        if (grid) { ret->m_field = m_field.clone(true); }
+        return ret;
+    }
+
+    SweepSolver(std::shared_ptr<Grid> const & grid, real_type time_increment, ctor_passkey const &)
+      : m_field(grid, time_increment, 1)
+    {}
+
+    SweepSolver() = delete;
+    SweepSolver(SweepSolver const & ) = default;
+    SweepSolver(SweepSolver       &&) = default;
+    SweepSolver & operator=(SweepSolver const & ) = default;
+    SweepSolver & operator=(SweepSolver       &&) = default;
+    ~SweepSolver() = default;
+
+    Grid const & grid() const { return m_field.grid(); }
+    Grid       & grid()       { return m_field.grid(); }
+
+    field_type const & field() const { return m_field; }
+    field_type       & field()       { return m_field; }
+
+    size_t nvar() const { return m_field.nvar(); }
+
+    /**
+     * (xsize, 1) arrays of so0 and so1, and the (xsize) CFL numbers.
+     */
+    array_type const & so0() const { return m_field.so0(); }
+    array_type       & so0()       { return m_field.so0(); }
+    array_type const & so1() const { return m_field.so1(); }
+    array_type       & so1()       { return m_field.so1(); }
+    array_type const & cfl() const { return m_field.cfl(); }
+    array_type       & cfl()       { return m_field.cfl(); }
+    std::shared_ptr<array_type const> shared_so0() const { return m_field.shared_so0(); }
+    std::shared_ptr<array_type      > shared_so0()       { return m_field.shared_so0(); }
+    std::shared_ptr<array_type const> shared_so1() const { return m_field.shared_so1(); }
+    std::shared_ptr<array_type      > shared_so1()       { return m_field.shared_so1(); }
+    std::shared_ptr<array_type const> shared_cfl() const { return m_field.shared_cfl(); }
+    std::shared_ptr<array_type      > shared_cfl()       { return m_field.shared_cfl(); }
+
+    /**
+     * Get and set the solution on the SEs of the plane, as
+     * SolverBase::get_so0() and SolverBase::set_so0() do.
+     */
+    array_type get_so0(size_t iv, bool odd_plane) const { return get_plane(m_field.so0(), iv, odd_plane, "get_so0()"); }
+    array_type get_so1(size_t iv, bool odd_plane) const { return get_plane(m_field.so1(), iv, odd_plane, "get_so1()"); }
+    array_type get_cfl(bool odd_plane) const { return get_plane(m_field.cfl(), 0, odd_plane, "get_cfl()"); }
+    void set_so0(size_t iv, array_type const & arr, bool odd_plane) { set_plane(m_field.so0(), iv, arr, odd_plane, "set_so0()"); }
+    void set_so1(size_t iv, array_type const & arr, bool odd_plane) { set_plane(m_field.so1(), iv, arr, odd_plane, "set_so1()"); }
+
+    real_type time_increment() const { return m_field.time_increment(); }
+    void set_time_increment(real_type time_increment) { m_field.set_time_increment(time_increment); }
+
+    /**
+     * Boundary conditions.  The callback condition is not supported, because
+     * the solution is not held in Field.
+     */
+    Boundary const & left_boundary() const { return m_left_boundary; }
+    Boundary const & right_boundary() const { return m_right_boundary; }
+    void set_left_boundary(Boundary const & bnd) { validate(bnd); m_left_boundary = bnd; }
+    void set_right_boundary(Boundary const & bnd) { validate(bnd); m_right_boundary = bnd; }
+
+    size_t nthread() const { return m_nthread; }
+    void set_nthread(size_t nthread) { m_nthread = std::max(size_t(1), nthread); }
+
+    /**
+     * Reallocate so0, so1 and the CFL numbers as SolverBase::place_memory()
+     * does.  The grid is left alone.
+     */
+    void place_memory(bool huge_pages=true)
+    {
+        m_field.place_memory(m_nthread, cache_line_align(2 * sizeof(value_type)), huge_pages);
+    }
+
+    size_t step() const { return m_step; }
+    void set_step(size_t step) { m_step = step; }
+
+    /**
+     * Maximum CFL number of the last update, as SolverBase::cfl_max().
+     */
+    value_type cfl_max() const { return m_cfl_max; }
+
+    void update_cfl(bool odd_plane);
+    void setup_march() { update_cfl(false); }
+    template <size_t ALPHA> void march_half_alpha(bool odd_plane);
+    template <size_t ALPHA> void march_alpha(size_t steps);
+
+private:
+
+    static void validate(Boundary const & bnd)
+    {
+        if (Boundary::CALLBACK == bnd.type())
+        {
+            throw std::invalid_argument("SweepSolver: callback boundary is not supported");
+        }
+        bnd.validate(1);
+    }
+
+    static value_type max_cfl(value_type lhs, value_type rhs) { return (lhs >= rhs || std::isnan(lhs)) ? lhs : rhs; }
+
+    value_type scan_cfl_max(bool odd_plane, sindex_type begin, sindex_type end) const
+    {
+        value_type ret = 0;
+        value_type const * cfl = m_field.cfl().data() + sweep_type::xindex_selm(0, odd_plane);
+        for (sindex_type is=begin; is<end; ++is) { ret = max_cfl(ret, cfl[is << 1]); }
+        return ret;
+    }
+
+    array_type get_plane(array_type const & arr, size_t iv, bool odd_plane, char const * name) const;
+    void set_plane(array_type & arr, size_t iv, array_type const & src, bool odd_plane, char const * name);
+
+    field_type m_field;
+    Boundary m_left_boundary;
+    Boundary m_right_boundary;
+    size_t m_nthread = 1;
+    size_t m_step = 0;
+    value_type m_cfl_max = 0;
+
+}; /* end class SweepSolver */
+
+template< typename FT, typename T, typename A >
+inline typename SweepSolver<FT, T, A>::array_type
+SweepSolver<FT, T, A>::get_plane(array_type const & arr, size_t iv, bool odd_plane, char const * name) const
+{
+    if (iv >= nvar()) { throw std::out_of_range(Formatter() << name << ": iv " << iv << " >= nvar " << nvar()); }
+    const size_t nselm = grid().nselm() - (odd_plane ? 1 : 0);
+    const size_t xbegin = sweep_type::xindex_selm(0, odd_plane);
+    array_type ret(std::vector<size_t>{nselm});
+    for (size_t it=0; it<nselm; ++it) { ret[it] = arr.data()[xbegin + (it << 1)]; }
+    return ret;
+}
+
+template< typename FT, typename T, typename A >
+inline void SweepSolver<FT, T, A>::set_plane(array_type & arr, size_t iv, array_type const & src, bool odd_plane, char const * name)
+{
+    if (iv >= nvar()) { throw std::out_of_range(Formatter() << name << ": iv " << iv << " >= nvar " << nvar()); }
+    if (1 != src.shape().size()) { throw std::out_of_range(Formatter() << name << ": input not 1D"); }
+    const size_t nselm = grid().nselm() - (odd_plane ? 1 : 0);
+    if (nselm != src.size())
+    {
+        throw std::out_of_range(Formatter() << name << ": arr size " << src.size() << " != nselm " << nselm);
+    }
+    const size_t xbegin = sweep_type::xindex_selm(0, odd_plane);
+    for (size_t it=0; it<nselm; ++it) { arr.data()[xbegin + (it << 1)] = src[it]; }
+}
+
+template< typename FT, typename T, typename A >
+inline void SweepSolver<FT, T, A>::update_cfl(bool odd_plane)
+{
+    const sindex_type start = odd_plane ? -1 : 0;
+    const sindex_type stop = grid().nselm();
+    // Take the maximum of each chunk while its CFL numbers are in cache.
+    m_cfl_max = parallel_reduce_chunk<value_type>
+    (
+        start, stop, m_nthread, cache_line_align(2 * sizeof(value_type))
+      , [this, odd_plane](sindex_type begin, sindex_type end)
+        {
+            sweep_type::update_cfl(m_field, odd_plane, begin, end);
+            return scan_cfl_max(odd_plane, begin, end);
+        }
+      , &max_cfl
+    );
+}
+
+/**
+ * Calculate so0, CFL and so1 of the top SEs of the CEs on the plane in one
+ * pass with ScalarSweep::march_fused_alpha().  The boundary is treated after
+ * the first half step.
+ */
+template< typename FT, typename T, typename A >
+template< size_t ALPHA >
+inline void SweepSolver<FT, T, A>::march_half_alpha(bool odd_plane)
+{
+    const sindex_type start = odd_plane ? -1 : 0;
+    const sindex_type stop = grid().ncelm();
+    // The top SE of CE ic is SE ic on the odd plane or SE ic+1 on the even
+    // plane.
+    const sindex_type top_offset = odd_plane ? 1 : 0;
+    m_cfl_max = parallel_reduce_chunk<value_type>
+    (
+        start, stop, m_nthread, cache_line_align(2 * sizeof(value_type))
+      , [this, odd_plane, top_offset](sindex_type begin, sindex_type end)
+        {
+            sweep_type::template march_fused_alpha<ALPHA>(m_field, odd_plane, begin, end);
+            return scan_cfl_max(!odd_plane, begin + top_offset, end + top_offset);
+        }
+      , &max_cfl
+    );
+    if (!odd_plane)
+    {
+        const sindex_type ncelm = grid().ncelm();
+        treat_ghost_rows(m_left_boundary, m_right_boundary, m_field.so0(), 0);
+        treat_ghost_rows(m_left_boundary, m_right_boundary, m_field.so1(), 1);
+        sweep_type::update_cfl(m_field, true, -1, 0);
+        sweep_type::update_cfl(m_field, true, ncelm, ncelm+1);
+        m_cfl_max = max_cfl(m_cfl_max, max_cfl(scan_cfl_max(true, -1, 0), scan_cfl_max(true, ncelm, ncelm+1)));
+    }
+}
+
+template< typename FT, typename T, typename A >
+template< size_t ALPHA >
+inline void SweepSolver<FT, T, A>::march_alpha(size_t steps)
+{
+    for (size_t it=0; it<steps; ++it)
+    {
+        march_half_alpha<ALPHA>(false);
+        march_half_alpha<ALPHA>(true);
+    }
+    m_step += steps;
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -11,8 +11,10 @@
 #include "spacetime/Celm.hpp"
 #include "spacetime/Solver.hpp"
 #include "spacetime/Selm.hpp"
+#include "spacetime/PolicySolver.hpp"
 #include "spacetime/kernel/linear_scalar.hpp"
 #include "spacetime/kernel/inviscid_burgers.hpp"
+#include "spacetime/kernel/euler.hpp"
 
 namespace spacetime
 {
@@ -54,6 +56,13 @@ std::ostream& operator<<(std::ostream& os, const Selm & elm)
     return os;
 }
 
+template< typename KP >
+std::ostream& operator<<(std::ostream& os, const PolicySolver<KP> & sol)
+{
+    os << "PolicySolver(grid=" << sol.grid() << ")";
+    return os;
+}
+
 inline
 std::ostream& operator<<(std::ostream& os, const InviscidBurgersSolver & sol)
 {
@@ -77,6 +86,29 @@ std::ostream& operator<<(std::ostream& os, const InviscidBurgersSelm & elm)
     return os;
 }
 
+inline
+std::ostream& operator<<(std::ostream& os, const EulerSolver & sol)
+{
+    os << "EulerSolver(grid=" << sol.grid() << ")";
+    return os;
+}
+
+inline
+std::ostream& operator<<(std::ostream& os, const EulerCelm & elm)
+{
+    os << "EulerCelm(" << (elm.on_even_plane() ? "even" : "odd") << ", ";
+    os << "index=" << elm.index() << ", x=" << elm.x() << ", xneg=" << elm.xneg() << ", xpos=" << elm.xpos() << ")";
+    return os;
+}
+
+inline
+std::ostream& operator<<(std::ostream& os, const EulerSelm & elm)
+{
+    os << "EulerSelm(" << (elm.on_even_plane() ? "even" : "odd") << ", ";
+    os << "index=" << elm.index() << ", x=" << elm.x() << ", xneg=" << elm.xneg() << ", xpos=" << elm.xpos() << ")";
+    return os;
+}
+
 inline
 std::ostream& operator<<(std::ostream& os, const LinearScalarSolver & sol)
 {
@@ -0,0 +1,428 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * One-dimensional Euler equations for a perfect gas.
+ *
+ * The conserved variables are u = (rho, rho v, rho e), where e is the specific
+ * total energy.  The space-time flux uses the flux Jacobian A = df/du, so that
+ * f_x = A u_x and f_t = A u_t = -A A u_x.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/ElementBase_decl.hpp"
+#include "spacetime/Grid_decl.hpp"
+#include "spacetime/Field_decl.hpp"
+#include "spacetime/SolverBase_decl.hpp"
+#include "spacetime/Sweep.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Flux and Jacobian of the Euler equations, following eqn_euler.f90 of
+ * osucese.
+ */
+struct EulerFlux
+{
+
+    using value_type = Field::value_type;
+
+    static constexpr size_t NVAR = 3;
+
+    /**
+     * Ratio of specific heats.
+     */
+    static constexpr value_type gamma() { return 1.4; }
+
+    static value_type flux(value_type const (&u)[NVAR], size_t iv)
+    {
+        constexpr value_type ga = gamma();
+        switch (iv)
+        {
+        case 0:
+            return u[1];
+        case 1:
+            return (ga-1)*u[2] + (3-ga)/2 * u[1]*u[1]/u[0];
+        default:
+            return ga*u[1]*u[2]/u[0] - (ga-1)/2 * u[1]*u[1]*u[1]/(u[0]*u[0]);
+        }
+    }
+
+    static void jacobian(value_type const (&u)[NVAR], value_type (&jac)[NVAR][NVAR])
+    {
+        constexpr value_type ga = gamma();
+        const value_type v = u[1] / u[0];
+        const value_type e = u[2] / u[0];
+        jac[0][0] = 0;
+        jac[0][1] = 1;
+        jac[0][2] = 0;
+        jac[1][0] = (ga-3)/2 * v*v;
+        jac[1][1] = -(ga-3) * v;
+        jac[1][2] = ga-1;
+        jac[2][0] = (ga-1) * v*v*v - ga * v*e;
+        jac[2][1] = ga*e - 1.5*(ga-1) * v*v;
+        jac[2][2] = ga * v;
+    }
+
+    /**
+     * A u_x of all variables.  The Jacobian A is returned in jac.
+     */
+    static void jacobian_ux
+    (
+        value_type const (&u)[NVAR], value_type const (&ux)[NVAR]
+      , value_type (&jac)[NVAR][NVAR], value_type (&aux)[NVAR]
+    )
+    {
+        jacobian(u, jac);
+        for (size_t it=0; it<NVAR; ++it)
+        {
+            aux[it] = jac[it][0]*ux[0] + jac[it][1]*ux[1] + jac[it][2]*ux[2];
+        }
+    }
+
+    /**
+     * Flux on the t-plane of all variables before multiplied by hdt, at the
+     * spatial displacement disp and the temporal displacement tdisp.
+     */
+    static void tflux
+    (
+        value_type const (&u)[NVAR], value_type const (&ux)[NVAR]
+      , value_type disp, value_type tdisp, value_type (&ret)[NVAR]
+    )
+    {
+        value_type jac[NVAR][NVAR];
+        value_type aux[NVAR];
+        jacobian_ux(u, ux, jac, aux);
+        for (size_t iv=0; iv<NVAR; ++iv)
+        {
+            const value_type ft = -(jac[iv][0]*aux[0] + jac[iv][1]*aux[1] + jac[iv][2]*aux[2]);
+            ret[iv] = flux(u, iv); /* f(u) */
+            ret[iv] += disp * aux[iv]; /* displacement in x */
+            ret[iv] += tdisp * ft; /* displacement in t */
+        }
+    }
+
+    /**
+     * Sound speed.
+     */
+    static value_type sound_speed(value_type const (&u)[NVAR])
+    {
+        constexpr value_type ga = gamma();
+        const value_type v = u[1] / u[0];
+        return std::sqrt(ga * (ga-1) * (u[2]/u[0] - v*v/2));
+    }
+
+}; /* end struct EulerFlux */
+
+class EulerSelm
+  : public Selm
+{
+
+    SPACETIME_DERIVED_SELM_BODY_DEFAULT
+
+private:
+
+    void load(value_type (&u)[EulerFlux::NVAR], value_type (&ux)[EulerFlux::NVAR]) const
+    {
+        for (size_t iv=0; iv<EulerFlux::NVAR; ++iv) { u[iv] = so0(iv); ux[iv] = so1(iv); }
+    }
+
+    /**
+     * Row iv of A u_x.
+     */
+    value_type fx(size_t iv) const;
+    /**
+     * Flux on the t-plane at the temporal displacement tdisp.
+     */
+    value_type tflux(size_t iv, value_type tdisp) const;
+
+}; /* end class EulerSelm */
+
+using EulerCelm = CelmBase<EulerSelm>;
+
+/**
+ * Element-free sweep for the Euler equations.  The proxies calculate one
+ * variable per call and build the flux Jacobian of an SE for each of them,
+ * while the sweep builds it once for all variables of the SE.  The arithmetic
+ * follows EulerSelm and Celm operation by operation, and the results are
+ * identical unless the geometry cache of the Grid is used.
+ */
+struct EulerSweep
+{
+
+    using value_type = Field::value_type;
+
+    static constexpr size_t NVAR = EulerFlux::NVAR;
+
+    static size_t xindex_celm(sindex_type ic, bool odd_plane)
+    {
+        return 1 + Grid::BOUND_COUNT + (ic << 1) + (odd_plane ? 1 : 0);
+    }
+
+    static size_t xindex_selm(sindex_type is, bool odd_plane)
+    {
+        return Grid::BOUND_COUNT + (is << 1) + (odd_plane ? 1 : 0);
+    }
+
+    /**
+     * Calculate so0 of the top SEs of the CEs [begin, end) on the plane.
+     */
+    static void march_so0(Field & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom)
+        {
+            for (sindex_type it=begin; it<end; ++it)
+            {
+                calc_so0(geom, field, xindex_celm(it, odd_plane));
+            }
+        });
+    }
+
+    /**
+     * Calculate so1 of the top SEs of the CEs [begin, end) on the plane.
+     */
+    template< size_t ALPHA >
+    static void march_so1_alpha(Field & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom)
+        {
+            for (sindex_type it=begin; it<end; ++it)
+            {
+                calc_so1_alpha<ALPHA>(geom, field, xindex_celm(it, odd_plane));
+            }
+        });
+    }
+
+    /**
+     * Update the CFL numbers of the SEs [begin, end) on the plane.
+     */
+    static void update_cfl(Field & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom)
+        {
+            for (sindex_type it=begin; it<end; ++it)
+            {
+                calc_cfl(geom, field, xindex_selm(it, odd_plane));
+            }
+        });
+    }
+
+    /**
+     * Calculate so0, CFL and so1 of the top SEs of the CEs [begin, end) on
+     * the plane in one pass.
+     */
+    template< size_t ALPHA >
+    static void march_fused_alpha(Field & field, bool odd_plane, sindex_type begin, sindex_type end)
+    {
+        with_geometry(field.grid(), [&](auto const & geom)
+        {
+            for (sindex_type it=begin; it<end; ++it)
+            {
+                const size_t ic = xindex_celm(it, odd_plane);
+                calc_so0(geom, field, ic);
+                calc_cfl(geom, field, ic);
+                calc_so1_alpha<ALPHA>(geom, field, ic);
+            }
+        });
+    }
+
+    static void load(Field const & field, size_t is, value_type (&u)[NVAR], value_type (&ux)[NVAR])
+    {
+        value_type const * urow = field.so0().data() + is * NVAR;
+        value_type const * uxrow = field.so1().data() + is * NVAR;
+        for (size_t iv=0; iv<NVAR; ++iv) { u[iv] = urow[iv]; ux[iv] = uxrow[iv]; }
+    }
+
+    /**
+     * so0 of the top SE of the CE at coordinate index ic.
+     */
+    template< typename G >
+    static void calc_so0(G const & geom, Field & field, size_t ic)
+    {
+        const size_t in = ic - 1;
+        const size_t ip = ic + 1;
+        const value_type hdt = field.hdt();
+        value_type un[NVAR], uxn[NVAR], up[NVAR], uxp[NVAR];
+        load(field, in, un, uxn);
+        load(field, ip, up, uxp);
+        value_type ntp[NVAR], ptp[NVAR];
+        EulerFlux::tflux(un, uxn, geom.disp(in), field.qdt(), ntp);
+        EulerFlux::tflux(up, uxp, geom.disp(ip), field.qdt(), ptp);
+        value_type * utp = field.so0().data() + ic * NVAR;
+        for (size_t iv=0; iv<NVAR; ++iv)
+        {
+            // Left SE: xp + tp.
+            const value_type nxp = geom.dxpos(in) * (un[iv] + geom.disppos(in) * uxn[iv]);
+            // Right SE: xn - tp.
+            const value_type pxn = geom.dxneg(ip) * (up[iv] + geom.dispneg(ip) * uxp[iv]);
+            const value_type flux_ll = nxp + hdt * ntp[iv];
+            const value_type flux_ur = pxn - hdt * ptp[iv];
+            utp[iv] = geom.div_dx(flux_ll + flux_ur, ic);
+        }
+    }
+
+    /**
+     * so0p of all variables of the SE at coordinate index is.
+     */
+    template< typename G >
+    static void calc_so0p(G const & geom, Field const & field, size_t is, value_type (&ret)[NVAR])
+    {
+        value_type u[NVAR], ux[NVAR];
+        load(field, is, u, ux);
+        value_type jac[NVAR][NVAR];
+        value_type aux[NVAR];
+        EulerFlux::jacobian_ux(u, ux, jac, aux);
+        for (size_t iv=0; iv<NVAR; ++iv)
+        {
+            ret[iv] = u[iv];
+            ret[iv] += geom.disp(is) * ux[iv]; /* displacement in x */
+            ret[iv] -= field.hdt() * aux[iv]; /* displacement in t */
+        }
+    }
+
+    /**
+     * so1 of the top SE of the CE at coordinate index ic, from the updated
+     * so0 of the top SE.
+     */
+    template< size_t ALPHA, typename G >
+    static void calc_so1_alpha(G const & geom, Field & field, size_t ic)
+    {
+        constexpr value_type tiny = std::numeric_limits<value_type>::min();
+        const size_t in = ic - 1;
+        const size_t ip = ic + 1;
+        value_type upn[NVAR], upp[NVAR];
+        calc_so0p(geom, field, in, upn);
+        calc_so0p(geom, field, ip, upp);
+        value_type const * utp = field.so0().data() + ic * NVAR;
+        value_type * uxtp = field.so1().data() + ic * NVAR;
+        for (size_t iv=0; iv<NVAR; ++iv)
+        {
+            const value_type duxn = geom.div_dxpos(utp[iv] - upn[iv], in);
+            const value_type duxp = geom.div_dxpos(upp[iv] - utp[iv], ic);
+            const value_type fan = pow<ALPHA>(std::fabs(duxn));
+            const value_type fap = pow<ALPHA>(std::fabs(duxp));
+            uxtp[iv] = (fap*duxn + fan*duxp) / (fap + fan + tiny);
+        }
+    }
+
+    /**
+     * CFL number of the SE at coordinate index is.
+     */
+    template< typename G >
+    static void calc_cfl(G const & geom, Field & field, size_t is)
+    {
+        value_type u[NVAR], ux[NVAR];
+        load(field, is, u, ux);
+        const value_type speed = std::fabs(u[1]/u[0]) + EulerFlux::sound_speed(u);
+        field.cfl(is) = speed * field.hdt() / geom.hdx(is);
+    }
+
+}; /* end struct EulerSweep */
+
+class EulerSolver
+  : public SolverBase<EulerSolver, EulerCelm, EulerSelm>
+{
+
+public:
+
+    using base_type = SolverBase<EulerSolver, EulerCelm, EulerSelm>;
+    using base_type::base_type;
+    using sweep_type = EulerSweep;
+
+    static std::shared_ptr<EulerSolver>
+    construct(std::shared_ptr<Grid> const & grid, value_type time_increment)
+    {
+        return construct_impl(grid, time_increment, size_t(EulerFlux::NVAR));
+    }
+
+}; /* end class EulerSolver */
+
+inline
+EulerSelm::value_type EulerSelm::fx(size_t iv) const
+{
+    value_type u[EulerFlux::NVAR];
+    value_type ux[EulerFlux::NVAR];
+    value_type jac[EulerFlux::NVAR][EulerFlux::NVAR];
+    load(u, ux);
+    EulerFlux::jacobian(u, jac);
+    return jac[iv][0]*ux[0] + jac[iv][1]*ux[1] + jac[iv][2]*ux[2];
+}
+
+inline
+EulerSelm::value_type EulerSelm::tflux(size_t iv, value_type tdisp) const
+{
+    value_type u[EulerFlux::NVAR];
+    value_type ux[EulerFlux::NVAR];
+    value_type ret[EulerFlux::NVAR];
+    load(u, ux);
+    EulerFlux::tflux(u, ux, x() - xctr(), tdisp, ret);
+    return hdt() * ret[iv];
+}
+
+/**
+ * Flux for the negative branch on the x-plane. (Flux direction in forward t.)
+ */
+inline
+EulerSelm::value_type EulerSelm::xn(size_t iv) const
+{
+    const value_type displacement = 0.5 * (x() + xneg()) - xctr();
+    return dxneg() * (so0(iv) + displacement * so1(iv));
+}
+
+/**
+ * Flux for the positive branch on the x-plane. (Flux direction in forward t.)
+ */
+inline
+EulerSelm::value_type EulerSelm::xp(size_t iv) const
+{
+    const value_type displacement = 0.5 * (x() + xpos()) - xctr();
+    return dxpos() * (so0(iv) + displacement * so1(iv));
+}
+
+/**
+ * Flux for the backward (behind) branch on the t-plane. (Flux direction in positive x.)
+ */
+inline
+EulerSelm::value_type EulerSelm::tn(size_t iv) const { return tflux(iv, -qdt()); }
+
+/**
+ * Flux for the forward (ahead) branch on the t-plane. (Flux direction in positive x.)
+ */
+inline
+EulerSelm::value_type EulerSelm::tp(size_t iv) const { return tflux(iv, qdt()); }
+
+/**
+ * Approximated value of the solution variable at the t+ tip of the solution element.
+ */
+inline
+EulerSelm::value_type EulerSelm::so0p(size_t iv) const
+{
+    value_type ret = so0(iv);
+    ret += (x()-xctr()) * so1(iv); /* displacement in x */
+    ret -= hdt() * fx(iv); /* displacement in t */
+    return ret;
+}
+
+inline
+void EulerSelm::update_cfl()
+{
+    value_type u[EulerFlux::NVAR];
+    value_type ux[EulerFlux::NVAR];
+    load(u, ux);
+    const value_type hdx = std::min(dxneg(), dxpos());
+    const value_type speed = std::fabs(u[1]/u[0]) + EulerFlux::sound_speed(u);
+    this->cfl() = speed * field().hdt() / hdx;
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -15,6 +15,7 @@
 #include "spacetime/Grid_decl.hpp"
 #include "spacetime/Field_decl.hpp"
 #include "spacetime/SolverBase_decl.hpp"
+#include "spacetime/Sweep.hpp"
 
 namespace spacetime
 {
@@ -30,6 +31,27 @@ class InviscidBurgersSelm
 
 using InviscidBurgersCelm = CelmBase<InviscidBurgersSelm>;
 
+/**
+ * Equation-dependent parts of the element-free sweep.
+ */
+struct InviscidBurgersFlux
+{
+
+    template< typename A >
+    static A tflux(A u, A ux, A disp, A sqdt)
+    {
+        const A u_2 = u * u;
+        A ret = A(0.5) * u_2; /* f(u) */
+        ret += disp * u * ux; /* displacement in x */
+        ret += sqdt * u_2 * ux; /* displacement in t */
+        return ret;
+    }
+
+    template< typename A >
+    static A cfl(A u, A hdt, A hdx) { return std::fabs(u) * hdt / hdx; }
+
+}; /* end struct InviscidBurgersFlux */
+
 class InviscidBurgersSolver
   : public SolverBase<InviscidBurgersSolver, InviscidBurgersCelm, InviscidBurgersSelm>
 {
@@ -38,6 +60,7 @@ public:
 
     using base_type = SolverBase<InviscidBurgersSolver, InviscidBurgersCelm, InviscidBurgersSelm>;
     using base_type::base_type;
+    using sweep_type = ScalarSweep<InviscidBurgersFlux>;
 
     static std::shared_ptr<InviscidBurgersSolver>
     construct(std::shared_ptr<Grid> const & grid, value_type time_increment)
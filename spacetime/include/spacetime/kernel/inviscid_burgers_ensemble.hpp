@@ -0,0 +1,26 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Ensembles of the inviscid Burgers equation.
+ */
+
+#include "spacetime/Ensemble.hpp"
+#include "spacetime/kernel/inviscid_burgers.hpp"
+
+namespace spacetime
+{
+
+using InviscidBurgersEnsemble = EnsembleSolver<InviscidBurgersFlux>;
+// Stored and calculated in float.
+using InviscidBurgersEnsembleF32 = EnsembleSolver<InviscidBurgersFlux, float>;
+// Stored in float and calculated in double.
+using InviscidBurgersEnsembleMixed = EnsembleSolver<InviscidBurgersFlux, float, double>;
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
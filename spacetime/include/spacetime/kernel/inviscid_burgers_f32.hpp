@@ -0,0 +1,23 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Single-precision solver of the inviscid Burgers equation.
+ */
+
+#include "spacetime/SweepSolver.hpp"
+#include "spacetime/kernel/inviscid_burgers.hpp"
+
+namespace spacetime
+{
+
+// Stored and calculated in float.
+using InviscidBurgersSolverF32 = SweepSolver<InviscidBurgersFlux, float>;
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
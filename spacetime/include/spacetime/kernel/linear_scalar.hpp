@@ -15,6 +15,7 @@
 #include "spacetime/Grid_decl.hpp"
 #include "spacetime/Field_decl.hpp"
 #include "spacetime/SolverBase_decl.hpp"
+#include "spacetime/Sweep.hpp"
 
 namespace spacetime
 {
@@ -27,6 +28,26 @@ class LinearScalarSelm
 
 using LinearScalarCelm = CelmBase<LinearScalarSelm>;
 
+/**
+ * Equation-dependent parts of the element-free sweep.
+ */
+struct LinearScalarFlux
+{
+
+    template< typename A >
+    static A tflux(A u, A ux, A disp, A sqdt)
+    {
+        A ret = u; /* f(u) */
+        ret += disp * ux; /* displacement in x; f_u == 1 */
+        ret += sqdt * ux; /* displacement in t */
+        return ret;
+    }
+
+    template< typename A >
+    static A cfl(A /*u*/, A hdt, A hdx) { return hdt / hdx; }
+
+}; /* end struct LinearScalarFlux */
+
 class LinearScalarSolver
   : public SolverBase<LinearScalarSolver, LinearScalarCelm, LinearScalarSelm>
 {
@@ -35,6 +56,7 @@ public:
 
     using base_type = SolverBase<LinearScalarSolver, LinearScalarCelm, LinearScalarSelm>;
     using base_type::base_type;
+    using sweep_type = ScalarSweep<LinearScalarFlux>;
 
     static std::shared_ptr<LinearScalarSolver>
     construct(std::shared_ptr<Grid> const & grid, value_type time_increment)
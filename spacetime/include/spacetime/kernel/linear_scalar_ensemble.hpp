@@ -0,0 +1,26 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Ensembles of the linear scalar equation.
+ */
+
+#include "spacetime/Ensemble.hpp"
+#include "spacetime/kernel/linear_scalar.hpp"
+
+namespace spacetime
+{
+
+using LinearScalarEnsemble = EnsembleSolver<LinearScalarFlux>;
+// Stored and calculated in float.
+using LinearScalarEnsembleF32 = EnsembleSolver<LinearScalarFlux, float>;
+// Stored in float and calculated in double.
+using LinearScalarEnsembleMixed = EnsembleSolver<LinearScalarFlux, float, double>;
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
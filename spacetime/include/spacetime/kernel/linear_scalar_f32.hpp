@@ -0,0 +1,23 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Single-precision solver of the linear scalar equation.
+ */
+
+#include "spacetime/SweepSolver.hpp"
+#include "spacetime/kernel/linear_scalar.hpp"
+
+namespace spacetime
+{
+
+// Stored and calculated in float.
+using LinearScalarSolverF32 = SweepSolver<LinearScalarFlux, float>;
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,136 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Placement of the large arrays in memory.
+ *
+ * Linux places a page on the NUMA node of the thread touching it first.  The
+ * arrays are therefore reallocated and filled by the threads marching them,
+ * with the partition of parallel_for_chunk().  The new buffers may also be
+ * advised to be backed by transparent huge pages before the first touch, to
+ * reduce TLB misses when sweeping long arrays.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/parallel.hpp"
+#include "spacetime/Grid_decl.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Array held by a shared pointer.  Replacing the array leaves the old one to
+ * the holders taken by share(), such as the Python views, instead of freeing
+ * it under them.  Copying copies the array.
+ */
+template< typename AT >
+class SharedArray
+{
+
+public:
+
+    explicit SharedArray(AT && arr) : m_ptr(std::make_shared<AT>(std::move(arr))) {}
+
+    SharedArray() = delete;
+    SharedArray(SharedArray const & other) : m_ptr(std::make_shared<AT>(*other.m_ptr)) {}
+    SharedArray(SharedArray       &&) = default;
+    SharedArray & operator=(SharedArray const & other)
+    {
+        if (this != &other) { m_ptr = std::make_shared<AT>(*other.m_ptr); }
+        return *this;
+    }
+    SharedArray & operator=(SharedArray       &&) = default;
+    ~SharedArray() = default;
+
+    SharedArray & operator=(AT && arr)
+    {
+        m_ptr = std::make_shared<AT>(std::move(arr));
+        return *this;
+    }
+
+    AT const & operator*() const { return *m_ptr; }
+    AT       & operator*()       { return *m_ptr; }
+    AT const * operator->() const { return m_ptr.get(); }
+    AT       * operator->()       { return m_ptr.get(); }
+
+    std::shared_ptr<AT const> share() const { return m_ptr; }
+    std::shared_ptr<AT      > share()       { return m_ptr; }
+
+private:
+
+    std::shared_ptr<AT> m_ptr;
+
+}; /* end class SharedArray */
+
+/**
+ * Advise the kernel to back the whole pages in [data, data+nbytes) by
+ * transparent huge pages.  It only affects the pages not touched yet.
+ * Return false if the advice is not supported or rejected.
+ */
+inline bool advise_huge_pages(void * data, size_t nbytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) / page * page;
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + nbytes) / page * page;
+    if (end <= begin) { return false; }
+    // NOLINTNEXTLINE(performance-no-int-to-ptr)
+    return 0 == madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE);
+#else
+    (void)data;
+    (void)nbytes;
+    return false;
+#endif
+}
+
+/**
+ * Copy the (xsize, ...) array of a grid of ncelm CEs to a new array.  The
+ * rows of the CEs [begin, end) are written by the thread that marches them in
+ * parallel_for_chunk(0, ncelm, nthread, align), and the rows of the ghost
+ * elements by the threads of the first and the last CEs.  An array of nblock
+ * such blocks stacked along the first axis is placed block by block.
+ */
+template< typename AT >
+inline AT place_rows(AT const & src, size_t ncelm, size_t nthread, size_t align, bool huge_pages, size_t nblock=1)
+{
+    using value_type = typename AT::value_type;
+    AT ret(src.shape());
+    if (huge_pages) { advise_huge_pages(ret.data(), ret.nbytes()); }
+    const size_t nrow = src.shape()[0];
+    const size_t xsize = nrow / nblock;
+    const size_t ncol = 0 == nrow ? 0 : src.size() / nrow;
+    value_type const * from = src.data();
+    value_type * to = ret.data();
+    parallel_for_chunk(0, ncelm, nthread, align, [=](sindex_type begin, sindex_type end)
+    {
+        if (end <= begin) { return; }
+        // The row of SE ic on the even plane is BOUND_COUNT + 2*ic.
+        const size_t rbegin = 0 == begin ? 0 : Grid::BOUND_COUNT + 2 * static_cast<size_t>(begin);
+        const size_t rend = static_cast<size_t>(end) == ncelm ? xsize : Grid::BOUND_COUNT + 2 * static_cast<size_t>(end);
+        for (size_t ib=0; ib<nblock; ++ib)
+        {
+            const size_t offset = (ib * xsize + rbegin) * ncol;
+            std::memcpy(to + offset, from + offset, (rend - rbegin) * ncol * sizeof(value_type));
+        }
+    });
+    return ret;
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
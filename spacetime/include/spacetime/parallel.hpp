@@ -0,0 +1,154 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+
+namespace spacetime
+{
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Static partition of the element interval [start, stop) for a thread.
+ * Chunk boundaries are kept at multiples of align elements from start, so
+ * that a chunk is made of whole groups of align elements.  The boundaries
+ * are not cache-line boundaries in memory: the row of element start is not
+ * aligned, so neighbouring threads may still share the line at the boundary.
+ */
+inline std::pair<sindex_type, sindex_type> static_chunk
+(
+    sindex_type start, sindex_type stop, size_t ithread, size_t nthread, size_t align
+)
+{
+    const size_t nelm = stop > start ? stop - start : 0;
+    const size_t nblock = (nelm + align - 1) / align;
+    const size_t base = nblock / nthread;
+    const size_t rem = nblock % nthread;
+    const size_t bbegin = ithread * base + std::min(ithread, rem);
+    const size_t bcount = base + (ithread < rem ? 1 : 0);
+    const sindex_type begin = start + std::min(nelm, bbegin * align);
+    const sindex_type end = start + std::min(nelm, (bbegin + bcount) * align);
+    return {begin, end};
+}
+
+/**
+ * Number of elements, each owning stride bytes of a row, to fill a cache
+ * line.
+ */
+inline size_t cache_line_align(size_t stride)
+{
+    return std::max(size_t(1), CACHE_LINE_SIZE / std::max(size_t(1), stride));
+}
+
+/**
+ * Call body(begin, end) for sub-intervals covering [start, stop).  With
+ * OpenMP and nthread > 1 the interval is statically partitioned with
+ * static_chunk().  An exception thrown by the body in a thread is rethrown
+ * after all threads finish; if several threads throw, one of them is kept.
+ */
+template< typename F >
+inline void parallel_for_chunk(sindex_type start, sindex_type stop, size_t nthread, size_t align, F && body)
+{
+#ifdef _OPENMP
+    if (nthread > 1)
+    {
+        std::exception_ptr error;
+#pragma omp parallel num_threads(nthread)
+        {
+            const auto range = static_chunk(start, stop, omp_get_thread_num(), omp_get_num_threads(), align);
+            try
+            {
+                body(range.first, range.second);
+            }
+            catch (...)
+            {
+#pragma omp critical(spacetime_parallel_error)
+                if (!error) { error = std::current_exception(); }
+            }
+        }
+        if (error) { std::rethrow_exception(error); }
+        return;
+    }
+#else
+    (void)nthread;
+    (void)align;
+#endif
+    body(start, stop);
+}
+
+/**
+ * Reduce body(begin, end) over sub-intervals covering [start, stop) with
+ * op(a, b), partitioned as parallel_for_chunk().  Exceptions are rethrown as
+ * in parallel_for_chunk().
+ */
+template< typename T, typename F, typename OP >
+inline T parallel_reduce_chunk(sindex_type start, sindex_type stop, size_t nthread, size_t align, F && body, OP && op)
+{
+#ifdef _OPENMP
+    if (nthread > 1)
+    {
+        std::vector<T> partial(nthread);
+        std::vector<char> done(nthread, 0);
+        std::exception_ptr error;
+#pragma omp parallel num_threads(nthread)
+        {
+            const size_t ithread = omp_get_thread_num();
+            const auto range = static_chunk(start, stop, ithread, omp_get_num_threads(), align);
+            try
+            {
+                partial[ithread] = body(range.first, range.second);
+                done[ithread] = 1;
+            }
+            catch (...)
+            {
+#pragma omp critical(spacetime_parallel_error)
+                if (!error) { error = std::current_exception(); }
+            }
+        }
+        if (error) { std::rethrow_exception(error); }
+        // The runtime may give fewer threads than asked for.
+        T ret = partial[0];
+        for (size_t it=1; it<nthread; ++it) { if (done[it]) { ret = op(ret, partial[it]); } }
+        return ret;
+    }
+#else
+    (void)nthread;
+    (void)align;
+    (void)op;
+#endif
+    return body(start, stop);
+}
+
+/**
+ * Call body(i) for i in [start, stop), partitioned as parallel_for_chunk().
+ */
+template< typename F >
+inline void parallel_for(sindex_type start, sindex_type stop, size_t nthread, size_t align, F && body)
+{
+    parallel_for_chunk
+    (
+        start, stop, nthread, align
+      , [&body](sindex_type begin, sindex_type end)
+        {
+            for (sindex_type it=begin; it<end; ++it) { body(it); }
+        }
+    );
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
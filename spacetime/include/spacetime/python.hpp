@@ -12,6 +12,9 @@
 
 #include "spacetime/python/wrapper_linear_scalar.hpp"
 #include "spacetime/python/wrapper_inviscid_burgers.hpp"
+#include "spacetime/python/wrapper_euler.hpp"
+#include "spacetime/python/wrapper_ensemble.hpp"
+#include "spacetime/python/wrapper_sweep_solver.hpp"
 #include "spacetime/python/wrapper_spacetime.hpp"
 #include "spacetime/python/WrapBase.hpp"
 
@@ -57,6 +60,15 @@ inline void initialize_impl(pybind11::module & mod)
     spy::WrapGrid::commit(mod, "Grid", "Spatial grid data");
     spy::WrapKernel::commit(mod, "Kernel", "Solution element calculation hooks");
     spy::WrapField::commit(mod, "Field", "Solution data");
+    pybind11::enum_<Boundary::Type>(mod, "BoundaryType")
+        .value("PERIODIC", Boundary::PERIODIC)
+        .value("EXTRAPOLATE", Boundary::EXTRAPOLATE)
+        .value("REFLECT", Boundary::REFLECT)
+        .value("DIRICHLET", Boundary::DIRICHLET)
+        .value("CALLBACK", Boundary::CALLBACK)
+    ;
+    spy::WrapBoundary::commit(mod, "Boundary", "Boundary condition at an end of the grid");
+    spy::WrapMarchTask::commit(mod, "MarchTask", "Marching of a solver in a background thread");
 
     add_solver
     <
@@ -77,6 +89,46 @@ inline void initialize_impl(pybind11::module & mod)
       , spy::WrapInviscidBurgersCelm
       , spy::WrapInviscidBurgersSelm
     >(mod, "InviscidBurgers", "the inviscid Burgers equation");
+
+    add_solver<
+        spy::WrapEulerSolver
+      , spy::WrapEulerCelm
+      , spy::WrapEulerSelm
+    >(mod, "Euler", "the Euler equations");
+
+    spy::WrapEnsembleSolver<LinearScalarEnsemble>::commit
+    (
+        mod, "LinearScalarEnsemble", "Ensemble of linear scalar problems on one grid"
+    );
+    spy::WrapEnsembleSolver<LinearScalarEnsembleF32>::commit
+    (
+        mod, "LinearScalarEnsembleF32", "Ensemble of linear scalar problems on one grid in float32"
+    );
+    spy::WrapEnsembleSolver<LinearScalarEnsembleMixed>::commit
+    (
+        mod, "LinearScalarEnsembleMixed", "Ensemble of linear scalar problems on one grid in float32, calculated in float64"
+    );
+    spy::WrapEnsembleSolver<InviscidBurgersEnsemble>::commit
+    (
+        mod, "InviscidBurgersEnsemble", "Ensemble of inviscid Burgers problems on one grid"
+    );
+    spy::WrapEnsembleSolver<InviscidBurgersEnsembleF32>::commit
+    (
+        mod, "InviscidBurgersEnsembleF32", "Ensemble of inviscid Burgers problems on one grid in float32"
+    );
+    spy::WrapEnsembleSolver<InviscidBurgersEnsembleMixed>::commit
+    (
+        mod, "InviscidBurgersEnsembleMixed", "Ensemble of inviscid Burgers problems on one grid in float32, calculated in float64"
+    );
+
+    spy::WrapSweepSolver<LinearScalarSolverF32>::commit
+    (
+        mod, "LinearScalarSolverF32", "Linear scalar solver in float32 marched by the sweep"
+    );
+    spy::WrapSweepSolver<InviscidBurgersSolverF32>::commit
+    (
+        mod, "InviscidBurgersSolverF32", "Inviscid Burgers solver in float32 marched by the sweep"
+    );
 }
 
 } /* end namespace detail */
@@ -17,8 +17,11 @@
 #include "modmesh/modmesh.hpp"
 
 #include <functional>
+#include <limits>
 #include <list>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 
 namespace spacetime
 {
@@ -32,6 +35,57 @@ template<class T> std::string to_str(T const & self) { return Formatter() << sel
 
 } /* end namespace detail */
 
+/**
+ * Throw if a MarchTask is marching the solver.  The task marches without the
+ * GIL, so Python must not touch the solver until the task is done.
+ */
+template< typename ST >
+void check_idle(ST const & sol, char const * name)
+{
+    if (MarchTask::busy(&sol))
+    {
+        throw std::runtime_error(Formatter()
+            << name << "(): the solver is marching asynchronously; wait for the task first");
+    }
+}
+
+/**
+ * Throw if a MarchTask is marching a solver on the grid, which reads the
+ * coordinates and the geometry cache without the GIL.
+ */
+inline void check_grid_idle(Grid const & grid, char const * name)
+{
+    if (MarchTask::busy_grid(&grid))
+    {
+        throw std::runtime_error(Formatter()
+            << name << "(): a solver on the grid is marching asynchronously; wait for the task first");
+    }
+}
+
+/**
+ * Wrap the member function f of solver type ST, so that it calls
+ * check_idle() first.
+ */
+template< typename ST, typename R, typename C, typename ... Args >
+auto idle(char const * name, R (C::*f)(Args ...))
+{
+    return [name, f](ST & self, Args ... args) -> R
+    {
+        check_idle(self, name);
+        return (self.*f)(std::forward<Args>(args) ...);
+    };
+}
+
+template< typename ST, typename R, typename C, typename ... Args >
+auto idle(char const * name, R (C::*f)(Args ...) const)
+{
+    return [name, f](ST const & self, Args ... args) -> R
+    {
+        check_idle(self, name);
+        return (self.*f)(std::forward<Args>(args) ...);
+    };
+}
+
 template <typename T>
 modmesh::SimpleArray<T> make_SimpleArray(pybind11::array_t<T> const & parr)
 {
@@ -40,6 +94,22 @@ modmesh::SimpleArray<T> make_SimpleArray(pybind11::array_t<T> const & parr)
     return sarr;
 }
 
+/**
+ * Reference to an array held by a shared pointer, which keeps the array,
+ * rather than its owner, alive.  It stays valid after the owner reallocates
+ * its arrays.
+ */
+template <typename T>
+pybind11::object share_SimpleArray(std::shared_ptr<modmesh::SimpleArray<T>> const & arr)
+{
+    namespace py = pybind11;
+    using holder_type = std::shared_ptr<modmesh::SimpleArray<T>>;
+    py::object ret = py::cast(arr.get(), py::return_value_policy::reference);
+    py::capsule holder(new holder_type(arr), [](void * ptr) { delete static_cast<holder_type *>(ptr); });
+    py::detail::keep_alive_impl(ret, holder);
+    return ret;
+}
+
 template<class WT, class ET>
 class
 WrapElementBase
@@ -172,17 +242,17 @@ protected:
             .def
             (
                 "set_so0"
-              , [](wrapped_type & self, size_t it, value_type val) { self.so0(it) = val; }
+              , [](wrapped_type & self, size_t it, value_type val) { self.so0(it) = val; self.field().kernel().drop_plane(); }
             )
             .def
             (
                 "set_so1"
-              , [](wrapped_type & self, size_t it, value_type val) { self.so1(it) = val; }
+              , [](wrapped_type & self, size_t it, value_type val) { self.so1(it) = val; self.field().kernel().drop_plane(); }
             )
             .def
             (
                 "set_cfl"
-              , [](wrapped_type & self, value_type val) { self.cfl() = val; }
+              , [](wrapped_type & self, value_type val) { self.cfl() = val; self.field().kernel().drop_plane(); }
             )
             .def("xn", &wrapped_type::xn)
             .def("xp", &wrapped_type::xp)
@@ -303,7 +373,7 @@ protected:
 
         (*this)
             .def("__str__", &detail::to_str<wrapped_type>)
-            .def("clone", &wrapped_type::clone, py::arg("grid")=false)
+            .def("clone", idle<wrapped_type>("clone", &wrapped_type::clone), py::arg("grid")=false)
             .def_property_readonly("grid", [](wrapped_type & self){ return self.grid().shared_from_this(); })
         ;
 
@@ -314,88 +384,219 @@ protected:
                 "xctr"
               , [](wrapped_type & self, bool odd_plane)
                 {
-                    auto sarr = self.xctr(odd_plane);
                     using value_type = typename wrapped_type::value_type;
-                    constexpr size_t itemsize = sizeof(value_type);
-                    py::array_t<value_type> rarr({ sarr.shape()[0] }, { itemsize });
+                    py::array_t<value_type> rarr(self.plane_nselm(odd_plane));
                     auto r = rarr.template mutable_unchecked<1>();
                     for (size_t it=0; it<r.shape(0); ++it)
-                    { r(it) = sarr(it); }
+                    { r(it) = self.selm(it, odd_plane).xctr(); }
                     return rarr;
                 }
               , py::arg("odd_plane")=false
             )
             .def_property_readonly("nvar", &wrapped_type::nvar)
+            .def_property("nthread", &wrapped_type::nthread, idle<wrapped_type>("nthread", &wrapped_type::set_nthread))
+            .def
+            (
+                "place_memory"
+              , idle<wrapped_type>("place_memory", &wrapped_type::place_memory)
+              , py::arg("huge_pages")=true
+              , "Reallocate the solution arrays for the threads marching them.  "
+                "Arrays and views taken before keep the old memory and no longer follow the solution.  "
+                "Elements taken before follow it.  The grid is not reallocated."
+            )
+            .def_property_readonly_static("has_sweep", [](py::object const &){ return wrapped_type::has_sweep(); })
+            .def_property("use_sweep", &wrapped_type::use_sweep, idle<wrapped_type>("use_sweep", &wrapped_type::set_use_sweep))
+            .def_property("use_fused", &wrapped_type::use_fused, idle<wrapped_type>("use_fused", &wrapped_type::set_use_fused))
+            .def_property("left_boundary", &wrapped_type::left_boundary, idle<wrapped_type>("left_boundary", &wrapped_type::set_left_boundary))
+            .def_property("right_boundary", &wrapped_type::right_boundary, idle<wrapped_type>("right_boundary", &wrapped_type::set_right_boundary))
+            .def_property_readonly("cfl_max", &wrapped_type::cfl_max)
+            .def_property("target_cfl", &wrapped_type::target_cfl, idle<wrapped_type>("target_cfl", &wrapped_type::set_target_cfl))
+            .def_property("max_dt_growth", &wrapped_type::max_dt_growth, idle<wrapped_type>("max_dt_growth", &wrapped_type::set_max_dt_growth))
+            .def_property
+            (
+                "max_time_increment"
+              , &wrapped_type::max_time_increment
+              , idle<wrapped_type>("max_time_increment", &wrapped_type::set_max_time_increment)
+            )
+            .def_property("block_steps", &wrapped_type::block_steps, idle<wrapped_type>("block_steps", &wrapped_type::set_block_steps))
+            .def_property("tile_ncelm", &wrapped_type::tile_ncelm, idle<wrapped_type>("tile_ncelm", &wrapped_type::set_tile_ncelm))
+            .def_property("lts_coarse", &wrapped_type::lts_coarse, idle<wrapped_type>("lts_coarse", &wrapped_type::set_lts_coarse))
+            .def
+            (
+                "adapt_flags"
+              , idle<wrapped_type>("adapt_flags", &wrapped_type::adapt_flags)
+              , py::arg("refine"), py::arg("coarsen")
+              , py::arg("min_width")=0
+              , py::arg("max_width")=std::numeric_limits<typename wrapped_type::value_type>::infinity()
+            )
+            .def("adapt", idle<wrapped_type>("adapt", &wrapped_type::adapt), py::arg("flags"))
+            .def("remesh", idle<wrapped_type>("remesh", &wrapped_type::remesh), py::arg("grid"))
+            .def_property("step", &wrapped_type::step, idle<wrapped_type>("step", &wrapped_type::set_step))
+            .def("write_checkpoint", idle<wrapped_type>("write_checkpoint", &wrapped_type::write_checkpoint), py::arg("path"))
+            .def("read_checkpoint", idle<wrapped_type>("read_checkpoint", &wrapped_type::read_checkpoint), py::arg("path"))
+            .def
+            (
+                "open_output"
+              , [](wrapped_type & self, std::string const & path, size_t interval, bool append)
+                {
+                    check_idle(self, "open_output");
+                    self.set_output(std::make_shared<SnapshotWriter>(path, append), interval);
+                }
+              , py::arg("path"), py::arg("interval"), py::arg("append")=false
+            )
+            .def("close_output", idle<wrapped_type>("close_output", &wrapped_type::close_output))
+            .def_property_readonly("output_interval", &wrapped_type::output_interval)
+            .def_property_readonly_static("profile_enabled", [](py::object const &){ return Profiler::enabled(); })
+            .def
+            (
+                "profile"
+              , [](wrapped_type const & self)
+                {
+                    py::dict ret;
+                    for (size_t it=0; it<Profiler::NPHASE; ++it)
+                    {
+                        const auto phase = static_cast<Profiler::Phase>(it);
+                        Profiler::Record const & rec = self.profiler().record(phase);
+                        py::dict item;
+                        item["seconds"] = rec.seconds;
+                        item["ncall"] = rec.ncall;
+                        item["nelm"] = rec.nelm;
+                        item["throughput"] = rec.throughput();
+                        ret[Profiler::phase_name(phase)] = item;
+                    }
+                    return ret;
+                }
+            )
+            .def("reset_profile", &wrapped_type::reset_profiler)
             .def_property(
                 "time_increment"
               , &wrapped_type::time_increment
-              , &wrapped_type::set_time_increment
+              , idle<wrapped_type>("time_increment", &wrapped_type::set_time_increment)
              )
             .def_property_readonly("dt", &wrapped_type::dt)
             .def_property_readonly("hdt", &wrapped_type::hdt)
             .def_property_readonly("qdt", &wrapped_type::qdt)
-            .def("celm" , static_cast<celm_getter>(&wrapped_type::celm_at)
+            .def("celm" , idle<wrapped_type>("celm", static_cast<celm_getter>(&wrapped_type::celm_at))
                , py::arg("ielm"), py::arg("odd_plane")=false)
-            .def("selm" , static_cast<selm_getter>(&wrapped_type::selm_at)
+            .def("selm" , idle<wrapped_type>("selm", static_cast<selm_getter>(&wrapped_type::selm_at))
                , py::arg("ielm"), py::arg("odd_plane")=false)
             .def
             (
                 "celms"
               , [](wrapped_type & self, bool odd_plane)
-                { return elm_iter_type(self.shared_from_this(), odd_plane, 0, false); }
+                {
+                    check_idle(self, "celms");
+                    return elm_iter_type(self.shared_from_this(), odd_plane, 0, false);
+                }
               , py::arg("odd_plane")=false
             )
             .def
             (
                 "selms"
               , [](wrapped_type & self, bool odd_plane)
-                { return elm_iter_type(self.shared_from_this(), odd_plane, 0, true); }
+                {
+                    check_idle(self, "selms");
+                    return elm_iter_type(self.shared_from_this(), odd_plane, 0, true);
+                }
               , py::arg("odd_plane")=false
             )
-            .def("get_so0p", &wrapped_type::get_so0p, py::arg("iv"), py::arg("odd_plane")=false)
+            .def("get_so0p", idle<wrapped_type>("get_so0p", &wrapped_type::get_so0p), py::arg("iv"), py::arg("odd_plane")=false)
         ;
 
 #define DECL_ST_WRAP_ARRAY_ACCESS_0D(NAME) \
     .def_property_readonly \
     ( \
         #NAME \
-      , static_cast<typename wrapped_type::array_type & (wrapped_type::*)()>(&wrapped_type::NAME) \
-      , py::return_value_policy::reference_internal \
+      , [](wrapped_type & self) \
+        { \
+            check_idle(self, #NAME); \
+            return share_SimpleArray(self.shared_ ## NAME()); \
+        } \
     ) \
     .def \
     ( \
         "get_" #NAME \
       , [](wrapped_type & self, bool odd_plane) \
-        { return self.get_ ## NAME(odd_plane); } \
+        { \
+            check_idle(self, "get_" #NAME); \
+            return self.get_ ## NAME(odd_plane); \
+        } \
+      , py::arg("odd_plane")=false \
+    ) \
+    .def \
+    ( \
+        "view_" #NAME \
+      , [](wrapped_type & self, bool odd_plane) \
+        { \
+            check_idle(self, "view_" #NAME); \
+            return make_plane_view(self, self.shared_ ## NAME(), 0, 1, odd_plane); \
+        } \
       , py::arg("odd_plane")=false \
     ) \
     .def \
     ( \
         "set_" #NAME \
-      , [](wrapped_type & self, py::array_t<typename wrapped_type::value_type> & arr, bool odd_plane) \
-        { self.set_ ## NAME(make_SimpleArray(arr), odd_plane); } \
+      , [](wrapped_type & self, py::array_t<typename wrapped_type::value_type> const & arr, bool odd_plane) \
+        { \
+            check_idle(self, "set_" #NAME); \
+            import_array(self, self.NAME(), "set_" #NAME, arr, 1, 0, 1, odd_plane); \
+        } \
       , py::arg("arr"), py::arg("odd_plane")=false \
     )
 #define DECL_ST_WRAP_ARRAY_ACCESS_1D(NAME) \
     .def_property_readonly \
     ( \
         #NAME \
-      , static_cast<typename wrapped_type::array_type & (wrapped_type::*)()>(&wrapped_type::NAME) \
-      , py::return_value_policy::reference_internal \
+      , [](wrapped_type & self) \
+        { \
+            check_idle(self, #NAME); \
+            return share_SimpleArray(self.shared_ ## NAME()); \
+        } \
     ) \
     .def \
     ( \
         "get_" #NAME \
       , [](wrapped_type & self, size_t iv, bool odd_plane) \
-        { return self.get_ ## NAME(iv, odd_plane); } \
+        { \
+            check_idle(self, "get_" #NAME); \
+            return self.get_ ## NAME(iv, odd_plane); \
+        } \
+      , py::arg("iv"), py::arg("odd_plane")=false \
+    ) \
+    .def \
+    ( \
+        "view_" #NAME \
+      , [](wrapped_type & self, size_t iv, bool odd_plane) \
+        { \
+            check_idle(self, "view_" #NAME); \
+            if (iv >= self.nvar()) { throw std::out_of_range("view_" #NAME "(): out of nvar range"); } \
+            return make_plane_view(self, self.shared_ ## NAME(), iv, self.nvar(), odd_plane); \
+        } \
       , py::arg("iv"), py::arg("odd_plane")=false \
     ) \
     .def \
     ( \
         "set_" #NAME \
-      , [](wrapped_type & self, size_t iv, py::array_t<typename wrapped_type::value_type> & arr, bool odd_plane) \
-        { self.set_ ## NAME(iv, make_SimpleArray(arr), odd_plane); } \
+      , [](wrapped_type & self, size_t iv, py::array_t<typename wrapped_type::value_type> const & arr, bool odd_plane) \
+        { \
+            check_idle(self, "set_" #NAME); \
+            if (iv >= self.nvar()) \
+            { \
+                throw std::out_of_range(Formatter() << "set_" #NAME "(): iv " << iv << " >= nvar " << self.nvar()); \
+            } \
+            import_array(self, self.NAME(), "set_" #NAME, arr, 1, iv, 1, odd_plane); \
+        } \
       , py::arg("iv"), py::arg("arr"), py::arg("odd_plane")=false \
+    ) \
+    .def \
+    ( \
+        "set_" #NAME \
+      , [](wrapped_type & self, py::array_t<typename wrapped_type::value_type> const & arr, bool odd_plane) \
+        { \
+            check_idle(self, "set_" #NAME); \
+            import_array(self, self.NAME(), "set_" #NAME, arr, 2, 0, self.nvar(), odd_plane); \
+        } \
+      , py::arg("arr"), py::arg("odd_plane")=false \
     )
         (*this)
             DECL_ST_WRAP_ARRAY_ACCESS_0D(cfl)
@@ -405,12 +606,24 @@ protected:
 #undef DECL_ST_WRAP_ARRAY_ACCESS_0D
 #undef DECL_ST_WRAP_ARRAY_ACCESS_1D
 
+        // Release the GIL while marching, so that solvers may march in
+        // Python threads.  Python callables in the boundary conditions
+        // reacquire it.  Solver keeps it, because all its kernel hooks may be
+        // Python callables, but the hooks also reacquire it, so that Solver
+        // may march asynchronously.
+        using march_guard = typename std::conditional
+        <
+            std::is_same<wrapped_type, Solver>::value
+          , py::call_guard<>
+          , py::call_guard<py::gil_scoped_release>
+        >::type;
+
         (*this)
-            .def("update_cfl", &wrapped_type::update_cfl, py::arg("odd_plane"))
-            .def("march_half_so0", &wrapped_type::march_half_so0, py::arg("odd_plane"))
-            .def("treat_boundary_so0", &wrapped_type::treat_boundary_so0)
-            .def("treat_boundary_so1", &wrapped_type::treat_boundary_so1)
-            .def("setup_march", &wrapped_type::setup_march)
+            .def("update_cfl", idle<wrapped_type>("update_cfl", &wrapped_type::update_cfl), py::arg("odd_plane"), march_guard())
+            .def("march_half_so0", idle<wrapped_type>("march_half_so0", &wrapped_type::march_half_so0), py::arg("odd_plane"), march_guard())
+            .def("treat_boundary_so0", idle<wrapped_type>("treat_boundary_so0", &wrapped_type::treat_boundary_so0))
+            .def("treat_boundary_so1", idle<wrapped_type>("treat_boundary_so1", &wrapped_type::treat_boundary_so1))
+            .def("setup_march", idle<wrapped_type>("setup_march", &wrapped_type::setup_march))
         ;
 
 #define DECL_ST_WRAP_MARCH_ALPHA(ALPHA) \
@@ -418,24 +631,68 @@ protected:
     ( \
         "march_half_so1_alpha"#ALPHA \
       , [](wrapped_type & self, bool odd_plane) \
-        { return self.template march_half_so1_alpha<ALPHA>(odd_plane); } \
-      , py::arg("odd_plane") \
+        { \
+            check_idle(self, "march_half_so1_alpha"#ALPHA); \
+            return self.template march_half_so1_alpha<ALPHA>(odd_plane); \
+        } \
+      , py::arg("odd_plane"), march_guard() \
+    ) \
+    .def \
+    ( \
+        "march_half_fused_alpha"#ALPHA \
+      , [](wrapped_type & self, bool odd_plane) \
+        { \
+            check_idle(self, "march_half_fused_alpha"#ALPHA); \
+            return self.template march_half_fused_alpha<ALPHA>(odd_plane); \
+        } \
+      , py::arg("odd_plane"), march_guard() \
     ) \
     .def \
     ( \
         "march_half1_alpha"#ALPHA \
-      , [](wrapped_type & self) { self.template march_half1_alpha<ALPHA>(); } \
+      , [](wrapped_type & self) \
+        { \
+            check_idle(self, "march_half1_alpha"#ALPHA); \
+            self.template march_half1_alpha<ALPHA>(); \
+        } \
+      , march_guard() \
     ) \
     .def \
     ( \
         "march_half2_alpha"#ALPHA \
-      , [](wrapped_type & self) { self.template march_half2_alpha<ALPHA>(); } \
+      , [](wrapped_type & self) \
+        { \
+            check_idle(self, "march_half2_alpha"#ALPHA); \
+            self.template march_half2_alpha<ALPHA>(); \
+        } \
+      , march_guard() \
     ) \
     .def \
     ( \
         "march_alpha"#ALPHA \
-      , [](wrapped_type & self, size_t steps) { self.template march_alpha<ALPHA>(steps); } \
-      , py::arg("steps") \
+      , [](wrapped_type & self, size_t steps) \
+        { \
+            check_idle(self, "march_alpha"#ALPHA); \
+            self.template march_alpha<ALPHA>(steps); \
+        } \
+      , py::arg("steps"), march_guard() \
+    ) \
+    .def \
+    ( \
+        "march_alpha"#ALPHA "_async" \
+      , [](wrapped_type & self, size_t steps, size_t chunk) \
+        { return march_alpha_async<ALPHA>(self.shared_from_this(), steps, chunk); } \
+      , py::arg("steps"), py::arg("chunk")=1 \
+    ) \
+    .def \
+    ( \
+        "march_lts_alpha"#ALPHA \
+      , [](wrapped_type & self, size_t steps) \
+        { \
+            check_idle(self, "march_lts_alpha"#ALPHA); \
+            self.template march_lts_alpha<ALPHA>(steps); \
+        } \
+      , py::arg("steps"), march_guard() \
     )
         (*this)
             DECL_ST_WRAP_MARCH_ALPHA(0)
@@ -446,6 +703,75 @@ protected:
 
     }
 
+private:
+
+    /**
+     * Copy the NumPy array to variables [ivbegin, ivbegin+nv) of the field
+     * array for the SEs on the plane, directly from its buffer.  A 1D array
+     * sets one variable, and a 2D (nselm, nv) array sets nv variables.
+     */
+    static void import_array
+    (
+        wrapped_type & self
+      , typename wrapped_type::array_type & dst
+      , char const * name
+      , pybind11::array_t<typename wrapped_type::value_type> const & arr
+      , size_t ndim
+      , size_t ivbegin
+      , size_t nv
+      , bool odd_plane
+    )
+    {
+        constexpr size_t itemsize = sizeof(typename wrapped_type::value_type);
+        if (ndim != static_cast<size_t>(arr.ndim()))
+        {
+            throw std::out_of_range(Formatter() << name << "(): input not " << ndim << "D");
+        }
+        const size_t nselm = self.plane_nselm(odd_plane);
+        if (static_cast<size_t>(arr.shape(0)) != nselm)
+        {
+            throw std::out_of_range(Formatter() << name << "(): arr size " << arr.shape(0) << " != nselm " << nselm);
+        }
+        if (2 == ndim && static_cast<size_t>(arr.shape(1)) != nv)
+        {
+            throw std::out_of_range(Formatter() << name << "(): arr columns " << arr.shape(1) << " != nvar " << nv);
+        }
+        const sindex_type row_stride = static_cast<sindex_type>(arr.strides(0) / static_cast<sindex_type>(itemsize));
+        const sindex_type col_stride = 2 == ndim ? static_cast<sindex_type>(arr.strides(1) / static_cast<sindex_type>(itemsize)) : 0;
+        self.import_plane(dst, arr.data(), row_stride, col_stride, ivbegin, nv, odd_plane);
+    }
+
+    /**
+     * Read-only view of variable iv of the (xsize, ncol) field array for the
+     * SEs on the plane, sharing memory with the field.  The view owns the
+     * array, so that it stays valid but stops following the solution after
+     * the field reallocates its arrays.
+     */
+    static pybind11::array make_plane_view
+    (
+        wrapped_type const & self
+      , std::shared_ptr<typename wrapped_type::array_type const> const & arr
+      , size_t iv
+      , size_t ncol
+      , bool odd_plane
+    )
+    {
+        namespace py = pybind11;
+        using holder_type = std::shared_ptr<typename wrapped_type::array_type const>;
+        constexpr size_t itemsize = sizeof(typename wrapped_type::value_type);
+        // A non-null base keeps pybind11 from copying the buffer.
+        py::capsule base(new holder_type(arr), [](void * ptr) { delete static_cast<holder_type *>(ptr); });
+        py::array ret
+        (
+            { self.plane_nselm(odd_plane) }
+          , { 2 * ncol * itemsize }
+          , arr->data() + wrapped_type::plane_xindex(odd_plane) * ncol + iv
+          , base
+        );
+        py::detail::array_proxy(ret.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+        return ret;
+    }
+
 }; /* end class WrapSolverBase */
 
 } /* end namespace python */
@@ -0,0 +1,184 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+#include <string>
+
+#include "spacetime/python/common.hpp"
+
+namespace spacetime
+{
+
+namespace python
+{
+
+template< typename ET >
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapEnsembleSolver
+  : public WrapBase< WrapEnsembleSolver<ET>, ET, std::shared_ptr<ET> >
+{
+
+    using base_type = WrapBase< WrapEnsembleSolver<ET>, ET, std::shared_ptr<ET> >;
+    using wrapper_type = typename base_type::wrapper_type;
+    using wrapped_type = typename base_type::wrapped_type;
+    using value_type = typename wrapped_type::value_type;
+
+    friend base_type;
+
+    WrapEnsembleSolver(pybind11::module & mod, const char * pyname, const char * clsdoc)
+      : base_type(mod, pyname, clsdoc)
+    {
+        namespace py = pybind11;
+
+        using set_dt_type = void (wrapped_type::*)(size_t, real_type);
+        using set_dt_all_type = void (wrapped_type::*)(real_type);
+
+        (*this)
+            .def
+            (
+                py::init(&wrapped_type::construct)
+              , py::arg("grid"), py::arg("nmember"), py::arg("time_increment")
+            )
+            .def_property_readonly("grid", [](wrapped_type & self){ return self.grid().shared_from_this(); })
+            .def_property_readonly("nmember", &wrapped_type::nmember)
+            .def_property("nthread", &wrapped_type::nthread, idle<wrapped_type>("nthread", &wrapped_type::set_nthread))
+            .def
+            (
+                "place_memory"
+              , idle<wrapped_type>("place_memory", &wrapped_type::place_memory)
+              , py::arg("huge_pages")=true
+              , "Reallocate the solution arrays for the threads marching them.  "
+                "Arrays taken before keep the old memory and no longer follow the solution."
+            )
+            .def_property("step", &wrapped_type::step, idle<wrapped_type>("step", &wrapped_type::set_step))
+            .def_property("left_boundary", &wrapped_type::left_boundary, idle<wrapped_type>("left_boundary", &wrapped_type::set_left_boundary))
+            .def_property("right_boundary", &wrapped_type::right_boundary, idle<wrapped_type>("right_boundary", &wrapped_type::set_right_boundary))
+            .def("time_increment", &wrapped_type::time_increment, py::arg("member"))
+            .def("set_time_increment", idle<wrapped_type>("set_time_increment", static_cast<set_dt_type>(&wrapped_type::set_time_increment))
+               , py::arg("member"), py::arg("time_increment"))
+            .def("set_time_increment", idle<wrapped_type>("set_time_increment", static_cast<set_dt_all_type>(&wrapped_type::set_time_increment))
+               , py::arg("time_increment"))
+            .def("cfl_max", &wrapped_type::cfl_max, py::arg("member"))
+            .def("update_cfl", idle<wrapped_type>("update_cfl", &wrapped_type::update_cfl), py::arg("odd_plane"), py::call_guard<py::gil_scoped_release>())
+            .def("setup_march", idle<wrapped_type>("setup_march", &wrapped_type::setup_march))
+        ;
+
+#define DECL_ST_WRAP_ENSEMBLE_ARRAY(NAME) \
+    .def_property_readonly \
+    ( \
+        #NAME \
+      , [](wrapped_type & self) \
+        { \
+            check_idle(self, #NAME); \
+            return share_SimpleArray(self.shared_ ## NAME()); \
+        } \
+    ) \
+    .def("get_" #NAME, idle<wrapped_type>("get_" #NAME, &wrapped_type::get_ ## NAME), py::arg("member"), py::arg("odd_plane")=false)
+
+        (*this)
+            DECL_ST_WRAP_ENSEMBLE_ARRAY(so0)
+            DECL_ST_WRAP_ENSEMBLE_ARRAY(so1)
+            DECL_ST_WRAP_ENSEMBLE_ARRAY(cfl)
+            .def
+            (
+                "set_so0"
+              , [](wrapped_type & self, py::array_t<value_type> const & arr, bool odd_plane)
+                {
+                    check_idle(self, "set_so0");
+                    import_array(self, self.so0(), "set_so0", arr, odd_plane);
+                }
+              , py::arg("arr"), py::arg("odd_plane")=false
+            )
+            .def
+            (
+                "set_so1"
+              , [](wrapped_type & self, py::array_t<value_type> const & arr, bool odd_plane)
+                {
+                    check_idle(self, "set_so1");
+                    import_array(self, self.so1(), "set_so1", arr, odd_plane);
+                }
+              , py::arg("arr"), py::arg("odd_plane")=false
+            )
+        ;
+#undef DECL_ST_WRAP_ENSEMBLE_ARRAY
+
+#define DECL_ST_WRAP_ENSEMBLE_MARCH_ALPHA(ALPHA) \
+    .def \
+    ( \
+        "march_half_alpha"#ALPHA \
+      , [](wrapped_type & self, bool odd_plane) \
+        { \
+            check_idle(self, "march_half_alpha"#ALPHA); \
+            self.template march_half_alpha<ALPHA>(odd_plane); \
+        } \
+      , py::arg("odd_plane"), py::call_guard<py::gil_scoped_release>() \
+    ) \
+    .def \
+    ( \
+        "march_alpha"#ALPHA \
+      , [](wrapped_type & self, size_t steps) \
+        { \
+            check_idle(self, "march_alpha"#ALPHA); \
+            self.template march_alpha<ALPHA>(steps); \
+        } \
+      , py::arg("steps"), py::call_guard<py::gil_scoped_release>() \
+    ) \
+    .def \
+    ( \
+        "march_alpha"#ALPHA "_async" \
+      , [](wrapped_type & self, size_t steps, size_t chunk) \
+        { return march_alpha_async<ALPHA>(self.shared_from_this(), steps, chunk); } \
+      , py::arg("steps"), py::arg("chunk")=1 \
+    )
+
+        (*this)
+            DECL_ST_WRAP_ENSEMBLE_MARCH_ALPHA(0)
+            DECL_ST_WRAP_ENSEMBLE_MARCH_ALPHA(1)
+            DECL_ST_WRAP_ENSEMBLE_MARCH_ALPHA(2)
+        ;
+#undef DECL_ST_WRAP_ENSEMBLE_MARCH_ALPHA
+    }
+
+private:
+
+    /**
+     * Copy the (nselm, nmember) NumPy array to the SEs on the plane for all
+     * members in one call, directly from its buffer.
+     */
+    static void import_array
+    (
+        wrapped_type & self
+      , typename wrapped_type::array_type & dst
+      , char const * name
+      , pybind11::array_t<value_type> const & arr
+      , bool odd_plane
+    )
+    {
+        constexpr size_t itemsize = sizeof(value_type);
+        const size_t nselm = self.grid().nselm() - (odd_plane ? 1 : 0);
+        const size_t nmember = self.nmember();
+        if (2 != arr.ndim() || static_cast<size_t>(arr.shape(0)) != nselm || static_cast<size_t>(arr.shape(1)) != nmember)
+        {
+            throw std::out_of_range(Formatter() << name << "(): input not (" << nselm << ", " << nmember << ")");
+        }
+        const sindex_type row_stride = static_cast<sindex_type>(arr.strides(0) / static_cast<sindex_type>(itemsize));
+        const sindex_type col_stride = static_cast<sindex_type>(arr.strides(1) / static_cast<sindex_type>(itemsize));
+        for (size_t it=0; it<nselm; ++it)
+        {
+            value_type const * src = arr.data() + static_cast<sindex_type>(it) * row_stride;
+            value_type * row = dst.data() + (Grid::BOUND_COUNT + (odd_plane ? 1 : 0) + (it << 1)) * nmember;
+            for (size_t im=0; im<nmember; ++im) { row[im] = src[static_cast<sindex_type>(im) * col_stride]; }
+        }
+    }
+
+}; /* end class WrapEnsembleSolver */
+
+} /* end namespace python */
+
+} /* end namespace spacetime */
+
+// vim: set et sw=4 ts=4:
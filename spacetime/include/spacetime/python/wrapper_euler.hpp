@@ -0,0 +1,79 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+#include "spacetime/python/common.hpp"
+
+namespace spacetime
+{
+
+namespace python
+{
+
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapEulerSolver
+  : public WrapSolverBase< WrapEulerSolver, EulerSolver >
+{
+
+    using base_type = WrapSolverBase< WrapEulerSolver, EulerSolver >;
+    using wrapper_type = typename base_type::wrapper_type;
+    using wrapped_type = typename base_type::wrapped_type;
+
+    friend base_type;
+    friend base_type::base_type;
+
+    WrapEulerSolver(pybind11::module & mod, const char * pyname, const char * clsdoc)
+      : base_type(mod, pyname, clsdoc)
+    {
+        namespace py = pybind11;
+        (*this)
+            .def(
+                py::init(static_cast<std::shared_ptr<wrapped_type> (*) (
+                    std::shared_ptr<Grid> const &, typename wrapped_type::value_type
+                )>(&wrapped_type::construct))
+              , py::arg("grid"), py::arg("time_increment")
+            )
+        ;
+    }
+
+}; /* end class WrapEulerSolver */
+
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapEulerCelm
+  : public WrapCelmBase< WrapEulerCelm, EulerCelm >
+{
+
+    using base_type = WrapCelmBase< WrapEulerCelm, EulerCelm >;
+    friend base_type::base_type::base_type;
+
+    WrapEulerCelm(pybind11::module & mod, const char * pyname, const char * clsdoc)
+      : base_type(mod, pyname, clsdoc)
+    {}
+
+}; /* end class WrapEulerCelm */
+
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapEulerSelm
+  : public WrapSelmBase< WrapEulerSelm, EulerSelm >
+{
+
+    using base_type = WrapSelmBase< WrapEulerSelm, EulerSelm >;
+    friend base_type::base_type::base_type;
+
+    WrapEulerSelm(pybind11::module & mod, const char * pyname, const char * clsdoc)
+      : base_type(mod, pyname, clsdoc)
+    {}
+
+}; /* end class WrapEulerSelm */
+
+} /* end namespace python */
+
+} /* end namespace spacetime */
+
+// vim: set et sw=4 ts=4:
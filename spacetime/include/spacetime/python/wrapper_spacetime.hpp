@@ -59,6 +59,27 @@ WrapGrid
               , static_cast<wrapped_type::array_type const & (wrapped_type::*)() const>(&wrapped_type::xcoord)
             )
             .def_property_readonly_static("BOUND_COUNT", [](py::object const &){ return Grid::BOUND_COUNT; })
+            .def_property_readonly_static("max_ncelm", [](py::object const &){ return Grid::max_ncelm(); })
+            .def("adapt", &wrapped_type::adapt, py::arg("flags"))
+            .def_property_readonly("has_geometry", &wrapped_type::has_geometry)
+            .def
+            (
+                "build_geometry"
+              , [](wrapped_type & self)
+                {
+                    check_grid_idle(self, "build_geometry");
+                    self.build_geometry();
+                }
+            )
+            .def
+            (
+                "clear_geometry"
+              , [](wrapped_type & self)
+                {
+                    check_grid_idle(self, "clear_geometry");
+                    self.clear_geometry();
+                }
+            )
         ;
     }
 
@@ -93,13 +114,286 @@ WrapKernel
             DECL_ST_WRAP_CALCULATORS(so0p_calc, calc_type1)
             DECL_ST_WRAP_CALCULATORS(cfl_updater, calc_type2)
             .def("reset", &wrapped_type::reset)
+            .def
+            (
+                "drop_plane"
+              , &wrapped_type::drop_plane
+              , "Drop the results of the plane hooks kept for the element calls.  "
+                "Call it after writing the solution through the array views."
+            )
         ;
 #undef DECL_ST_WRAP_CALCULATORS
 
+        // The plane hooks take a Python callable f(so0, so1, x, dxneg,
+        // dxpos) receiving arrays for all solution elements on the plane and
+        // returning the (n, nvar) result (or the (n,) CFL numbers).
+#define DECL_ST_WRAP_PLANE_CALCULATORS(NAME, MAKER) \
+    .def_property \
+    ( \
+        #NAME \
+      , [](wrapped_type & self) \
+        { \
+            return self.NAME() ? py::object(py::cpp_function(self.NAME())) : py::object(py::none()); \
+        } \
+      , [](wrapped_type & self, py::object const & f) \
+        { \
+            if (f.is_none()) { self.NAME() = nullptr; } \
+            else { self.NAME() = MAKER(f); } \
+            self.drop_plane(); \
+        } \
+    )
+        (*this)
+            DECL_ST_WRAP_PLANE_CALCULATORS(xn_plane_calc, make_plane_calc)
+            DECL_ST_WRAP_PLANE_CALCULATORS(xp_plane_calc, make_plane_calc)
+            DECL_ST_WRAP_PLANE_CALCULATORS(tn_plane_calc, make_plane_calc)
+            DECL_ST_WRAP_PLANE_CALCULATORS(tp_plane_calc, make_plane_calc)
+            DECL_ST_WRAP_PLANE_CALCULATORS(so0p_plane_calc, make_plane_calc)
+            DECL_ST_WRAP_PLANE_CALCULATORS(cfl_plane_updater, make_plane_cfl_updater)
+        ;
+#undef DECL_ST_WRAP_PLANE_CALCULATORS
+
+    }
+
+    /**
+     * x, dxneg and dxpos of the SEs on the two planes of a grid, for the
+     * arguments to the Python plane hooks.  They depend only on the grid, so
+     * a hook builds them once and passes read-only views owning them.  Like
+     * the geometry cache of the grid, they do not follow changes of xcoord()
+     * in place, but are rebuilt when the grid reallocates its coordinates.
+     */
+    struct PlaneCoord
+    {
+        std::weak_ptr<Grid const> grid;
+        real_type const * xdata = nullptr;
+        size_t xsize = 0;
+        // Rows x, dxneg and dxpos, for the even and odd plane.
+        wrapped_type::array_type values[2];
+    }; /* end struct PlaneCoord */
+
+    using plane_coord_holder = std::shared_ptr<PlaneCoord const>;
+
+    /**
+     * Take the coordinates of the grid from the cache of a hook, and build
+     * them when the cache is for another grid.
+     */
+    static plane_coord_holder const & plane_coord(plane_coord_holder & cache, Grid const & grid)
+    {
+        real_type const * xptr = grid.xcoord().data();
+        if (cache && cache->xdata == xptr && cache->xsize == grid.xsize() && cache->grid.lock().get() == &grid)
+        {
+            return cache;
+        }
+        std::shared_ptr<PlaneCoord> ret = std::make_shared<PlaneCoord>();
+        ret->grid = grid.shared_from_this();
+        ret->xdata = xptr;
+        ret->xsize = grid.xsize();
+        for (size_t ip=0; ip<2; ++ip)
+        {
+            const bool odd_plane = 0 != ip;
+            const size_t xbegin = wrapped_type::plane_xbegin(odd_plane);
+            const size_t nelm = wrapped_type::plane_size(grid, odd_plane);
+            wrapped_type::array_type & arr = ret->values[ip];
+            arr = wrapped_type::array_type(std::vector<size_t>{3, nelm});
+            for (size_t it=0; it<nelm; ++it)
+            {
+                const size_t ix = xbegin + (it << 1);
+                arr(0, it) = xptr[ix];
+                arr(1, it) = xptr[ix] - xptr[ix-1];
+                arr(2, it) = xptr[ix+1] - xptr[ix];
+            }
+        }
+        cache = std::move(ret);
+        return cache;
+    }
+
+    /**
+     * Build the arguments to a Python plane hook.  The arguments are
+     * read-only views owning the arrays they view, so that a hook keeping
+     * them does not see freed memory after the field or the grid
+     * reallocates.  so0 and so1 are the field arrays, and x, dxneg and dxpos
+     * are from the coordinate cache of the hook.
+     */
+    static pybind11::tuple make_plane_args(Field const & field, bool odd_plane, plane_coord_holder & cache)
+    {
+        namespace py = pybind11;
+        using value_type = wrapped_type::value_type;
+        using holder_type = std::shared_ptr<wrapped_type::array_type const>;
+        constexpr size_t itemsize = sizeof(value_type);
+
+        const size_t xbegin = wrapped_type::plane_xbegin(odd_plane);
+        const size_t nelm = wrapped_type::plane_size(field.grid(), odd_plane);
+        const size_t nvar = field.nvar();
+
+        // A non-null base keeps pybind11 from copying the buffer.
+        auto make_view = [](auto const & holder, py::array::ShapeContainer shape, py::array::StridesContainer strides, value_type const * data)
+        {
+            using base_type = std::decay_t<decltype(holder)>;
+            py::capsule base(new base_type(holder), [](void * ptr) { delete static_cast<base_type *>(ptr); });
+            py::array ret(std::move(shape), std::move(strides), data, base);
+            py::detail::array_proxy(ret.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+            return ret;
+        };
+        auto make_so_view = [&](holder_type const & arr)
+        {
+            return make_view(arr, {nelm, nvar}, {2*nvar*itemsize, itemsize}, arr->data() + xbegin*nvar);
+        };
+        py::array so0 = make_so_view(field.shared_so0());
+        py::array so1 = make_so_view(field.shared_so1());
+
+        plane_coord_holder const & coord = plane_coord(cache, field.grid());
+        value_type const * cptr = coord->values[odd_plane ? 1 : 0].data();
+        py::array x = make_view(coord, {nelm}, {itemsize}, cptr);
+        py::array dxneg = make_view(coord, {nelm}, {itemsize}, cptr + nelm);
+        py::array dxpos = make_view(coord, {nelm}, {itemsize}, cptr + 2*nelm);
+
+        return py::make_tuple(so0, so1, x, dxneg, dxpos);
+    }
+
+    /**
+     * Hold the Python callable of a hook.  The hooks are called, copied and
+     * destroyed by threads not holding the GIL (when marching asynchronously),
+     * so the holder takes the GIL to release the callable, and the hooks take
+     * it to call.
+     */
+    static std::shared_ptr<pybind11::object> hold_callable(pybind11::object const & func)
+    {
+        namespace py = pybind11;
+        return std::shared_ptr<py::object>
+        (
+            new py::object(func)
+          , [](py::object * ptr)
+            {
+                py::gil_scoped_acquire gil;
+                delete ptr;
+            }
+        );
+    }
+
+    static wrapped_type::calc_plane_type1 make_plane_calc(pybind11::object const & func)
+    {
+        namespace py = pybind11;
+        using value_type = wrapped_type::value_type;
+        return [func=hold_callable(func), cache=plane_coord_holder()](Field const & field, bool odd_plane, wrapped_type::array_type & ret) mutable
+        {
+            py::gil_scoped_acquire gil;
+            const size_t xbegin = wrapped_type::plane_xbegin(odd_plane);
+            const size_t nelm = wrapped_type::plane_size(field.grid(), odd_plane);
+            const size_t nvar = field.nvar();
+            py::array_t<value_type, py::array::c_style | py::array::forcecast> res(
+                (*func)(*make_plane_args(field, odd_plane, cache)));
+            if (static_cast<size_t>(res.size()) != nelm * nvar)
+            {
+                throw std::length_error(Formatter()
+                    << "Kernel plane hook: result size " << res.size()
+                    << " != " << nelm << " * nvar " << nvar);
+            }
+            value_type const * rptr = res.data();
+            for (size_t it=0; it<nelm; ++it)
+            {
+                const size_t ix = xbegin + (it << 1);
+                for (size_t iv=0; iv<nvar; ++iv) { ret(ix, iv) = rptr[it*nvar+iv]; }
+            }
+        };
+    }
+
+    static wrapped_type::calc_plane_type2 make_plane_cfl_updater(pybind11::object const & func)
+    {
+        namespace py = pybind11;
+        using value_type = wrapped_type::value_type;
+        return [func=hold_callable(func), cache=plane_coord_holder()](Field & field, bool odd_plane) mutable
+        {
+            py::gil_scoped_acquire gil;
+            const size_t xbegin = wrapped_type::plane_xbegin(odd_plane);
+            const size_t nelm = wrapped_type::plane_size(field.grid(), odd_plane);
+            py::array_t<value_type, py::array::c_style | py::array::forcecast> res(
+                (*func)(*make_plane_args(field, odd_plane, cache)));
+            if (static_cast<size_t>(res.size()) != nelm)
+            {
+                throw std::length_error(Formatter()
+                    << "Kernel plane CFL updater: result size " << res.size() << " != " << nelm);
+            }
+            value_type const * rptr = res.data();
+            for (size_t it=0; it<nelm; ++it) { field.cfl(xbegin + (it << 1)) = rptr[it]; }
+        };
     }
 
 }; /* end class WrapKernel */
 
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapBoundary
+  : public WrapBase< WrapBoundary, Boundary >
+{
+
+    friend root_base_type;
+
+    WrapBoundary(pybind11::module & mod, const char * pyname, const char * clsdoc)
+      : root_base_type(mod, pyname, clsdoc)
+    {
+        namespace py = pybind11;
+        using value_type = wrapped_type::value_type;
+
+        (*this)
+            .def(py::init<>())
+            .def_static("periodic", &wrapped_type::periodic)
+            .def_static("extrapolate", &wrapped_type::extrapolate)
+            .def_static
+            (
+                "reflect"
+              , &wrapped_type::reflect
+              , py::arg("signs")=std::vector<value_type>()
+            )
+            .def_static("dirichlet", &wrapped_type::dirichlet, py::arg("values"))
+            // The callable takes (ghost, inner, order) and sets so0 of the
+            // ghost Selm for order 0 and so1 for order 1.
+            .def_static("callback", &wrapped_type::callback, py::arg("func"))
+            .def_property_readonly("type", &wrapped_type::type)
+            .def_property_readonly("values", &wrapped_type::values)
+        ;
+    }
+
+}; /* end class WrapBoundary */
+
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapMarchTask
+  : public WrapBase< WrapMarchTask, MarchTask, std::shared_ptr<MarchTask> >
+{
+
+    friend root_base_type;
+
+    WrapMarchTask(pybind11::module & mod, const char * pyname, const char * clsdoc)
+      : root_base_type(mod, pyname, clsdoc)
+    {
+        namespace py = pybind11;
+
+        (*this)
+            .def_property_readonly("steps", &wrapped_type::steps)
+            .def_property_readonly("chunk", &wrapped_type::chunk)
+            .def_property_readonly("progress", &wrapped_type::progress)
+            .def_property_readonly("done", &wrapped_type::done)
+            .def_property_readonly("cancelled", &wrapped_type::cancelled)
+            .def("cancel", &wrapped_type::cancel)
+            // Wait without the GIL, so that the marching thread may call back
+            // into Python.  A timeout of None waits until done.
+            .def
+            (
+                "wait"
+              , [](wrapped_type const & self, py::object const & timeout)
+                {
+                    const double seconds = timeout.is_none() ? -1 : timeout.cast<double>();
+                    py::gil_scoped_release release;
+                    return self.wait(seconds);
+                }
+              , py::arg("timeout")=py::none()
+            )
+            .def("result", &wrapped_type::get, py::call_guard<py::gil_scoped_release>())
+            .def_static("cancel_all", &wrapped_type::cancel_all, py::call_guard<py::gil_scoped_release>())
+        ;
+    }
+
+}; /* end class WrapMarchTask */
+
 class
 SPACETIME_PYTHON_WRAPPER_VISIBILITY
 WrapField
@@ -173,7 +467,27 @@ WrapSolver
             .def_property_readonly
             (
                 "kernel"
-              , [](wrapped_type & self) -> Kernel & { return self.kernel(); }
+              , [](wrapped_type & self) -> Kernel &
+                {
+                    check_idle(self, "kernel");
+                    return self.kernel();
+                }
+            )
+            // The per-element kernel hooks may call into Python, which must
+            // not happen from the marching threads.
+            .def_property
+            (
+                "nthread"
+              , &wrapped_type::nthread
+              , [](wrapped_type & self, size_t nthread)
+                {
+                    check_idle(self, "nthread");
+                    if (nthread > 1)
+                    {
+                        throw std::invalid_argument("Solver with kernel hooks only marches in one thread");
+                    }
+                    self.set_nthread(nthread);
+                }
             )
         ;
     }
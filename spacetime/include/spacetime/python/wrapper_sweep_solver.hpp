@@ -0,0 +1,164 @@
+#pragma once
+
+/*
+ * Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+#include <string>
+
+#include "spacetime/python/common.hpp"
+
+namespace spacetime
+{
+
+namespace python
+{
+
+template< typename ST >
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapSweepSolver
+  : public WrapBase< WrapSweepSolver<ST>, ST, std::shared_ptr<ST> >
+{
+
+    using base_type = WrapBase< WrapSweepSolver<ST>, ST, std::shared_ptr<ST> >;
+    using wrapper_type = typename base_type::wrapper_type;
+    using wrapped_type = typename base_type::wrapped_type;
+    using value_type = typename wrapped_type::value_type;
+
+    friend base_type;
+
+    WrapSweepSolver(pybind11::module & mod, const char * pyname, const char * clsdoc)
+      : base_type(mod, pyname, clsdoc)
+    {
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init(&wrapped_type::construct)
+              , py::arg("grid"), py::arg("time_increment")
+            )
+            .def("clone", idle<wrapped_type>("clone", &wrapped_type::clone), py::arg("grid")=false)
+            .def_property_readonly("grid", [](wrapped_type & self){ return self.grid().shared_from_this(); })
+            .def_property_readonly("nvar", &wrapped_type::nvar)
+            .def_property("nthread", &wrapped_type::nthread, idle<wrapped_type>("nthread", &wrapped_type::set_nthread))
+            .def
+            (
+                "place_memory"
+              , idle<wrapped_type>("place_memory", &wrapped_type::place_memory)
+              , py::arg("huge_pages")=true
+              , "Reallocate the solution arrays for the threads marching them.  "
+                "Arrays taken before keep the old memory and no longer follow the solution."
+            )
+            .def_property("step", &wrapped_type::step, idle<wrapped_type>("step", &wrapped_type::set_step))
+            .def_property("left_boundary", &wrapped_type::left_boundary, idle<wrapped_type>("left_boundary", &wrapped_type::set_left_boundary))
+            .def_property("right_boundary", &wrapped_type::right_boundary, idle<wrapped_type>("right_boundary", &wrapped_type::set_right_boundary))
+            .def_property
+            (
+                "time_increment"
+              , &wrapped_type::time_increment
+              , idle<wrapped_type>("time_increment", &wrapped_type::set_time_increment)
+            )
+            .def_property_readonly("cfl_max", &wrapped_type::cfl_max)
+            .def("update_cfl", idle<wrapped_type>("update_cfl", &wrapped_type::update_cfl), py::arg("odd_plane"), py::call_guard<py::gil_scoped_release>())
+            .def("setup_march", idle<wrapped_type>("setup_march", &wrapped_type::setup_march))
+            .def
+            (
+                "get_cfl"
+              , idle<wrapped_type>("get_cfl", &wrapped_type::get_cfl)
+              , py::arg("odd_plane")=false
+            )
+        ;
+
+#define DECL_ST_WRAP_SWEEP_ARRAY(NAME) \
+    .def_property_readonly \
+    ( \
+        #NAME \
+      , [](wrapped_type & self) \
+        { \
+            check_idle(self, #NAME); \
+            return share_SimpleArray(self.shared_ ## NAME()); \
+        } \
+    )
+#define DECL_ST_WRAP_SWEEP_ARRAY_1D(NAME) \
+    DECL_ST_WRAP_SWEEP_ARRAY(NAME) \
+    .def("get_" #NAME, idle<wrapped_type>("get_" #NAME, &wrapped_type::get_ ## NAME), py::arg("iv"), py::arg("odd_plane")=false) \
+    .def \
+    ( \
+        "set_" #NAME \
+      , [](wrapped_type & self, size_t iv, py::array_t<value_type> const & arr, bool odd_plane) \
+        { \
+            check_idle(self, "set_" #NAME); \
+            self.set_ ## NAME(iv, to_array(arr, "set_" #NAME), odd_plane); \
+        } \
+      , py::arg("iv"), py::arg("arr"), py::arg("odd_plane")=false \
+    )
+
+        (*this)
+            DECL_ST_WRAP_SWEEP_ARRAY(cfl)
+            DECL_ST_WRAP_SWEEP_ARRAY_1D(so0)
+            DECL_ST_WRAP_SWEEP_ARRAY_1D(so1)
+        ;
+#undef DECL_ST_WRAP_SWEEP_ARRAY_1D
+#undef DECL_ST_WRAP_SWEEP_ARRAY
+
+#define DECL_ST_WRAP_SWEEP_MARCH_ALPHA(ALPHA) \
+    .def \
+    ( \
+        "march_half_alpha"#ALPHA \
+      , [](wrapped_type & self, bool odd_plane) \
+        { \
+            check_idle(self, "march_half_alpha"#ALPHA); \
+            self.template march_half_alpha<ALPHA>(odd_plane); \
+        } \
+      , py::arg("odd_plane"), py::call_guard<py::gil_scoped_release>() \
+    ) \
+    .def \
+    ( \
+        "march_alpha"#ALPHA \
+      , [](wrapped_type & self, size_t steps) \
+        { \
+            check_idle(self, "march_alpha"#ALPHA); \
+            self.template march_alpha<ALPHA>(steps); \
+        } \
+      , py::arg("steps"), py::call_guard<py::gil_scoped_release>() \
+    ) \
+    .def \
+    ( \
+        "march_alpha"#ALPHA "_async" \
+      , [](wrapped_type & self, size_t steps, size_t chunk) \
+        { return march_alpha_async<ALPHA>(self.shared_from_this(), steps, chunk); } \
+      , py::arg("steps"), py::arg("chunk")=1 \
+    )
+
+        (*this)
+            DECL_ST_WRAP_SWEEP_MARCH_ALPHA(0)
+            DECL_ST_WRAP_SWEEP_MARCH_ALPHA(1)
+            DECL_ST_WRAP_SWEEP_MARCH_ALPHA(2)
+        ;
+#undef DECL_ST_WRAP_SWEEP_MARCH_ALPHA
+    }
+
+private:
+
+    /**
+     * Copy the 1D NumPy array into a SimpleArray of the value type.
+     */
+    static typename wrapped_type::array_type to_array(pybind11::array_t<value_type> const & arr, char const * name)
+    {
+        if (1 != arr.ndim()) { throw std::out_of_range(Formatter() << name << "(): input not 1D"); }
+        typename wrapped_type::array_type ret(std::vector<size_t>{static_cast<size_t>(arr.shape(0))});
+        auto src = arr.template unchecked<1>();
+        for (size_t it=0; it<ret.size(); ++it) { ret[it] = src(it); }
+        return ret;
+    }
+
+}; /* end class WrapSweepSolver */
+
+} /* end namespace python */
+
+} /* end namespace spacetime */
+
+// vim: set et sw=4 ts=4:
@@ -5,12 +5,26 @@
  * BSD 3-Clause License, see COPYING
  */
 
+#include <cstdint>
+
 namespace spacetime
 {
 
 using real_type = double;
+
+/**
+ * Element indices are 32-bit unless SPACETIME_INDEX64 is defined (CMake
+ * option USE_INDEX64).  The coordinate index of an element is twice its
+ * index, so 32-bit indices limit a grid to about 2^30 CEs (see
+ * Grid::max_ncelm()).
+ */
+#ifdef SPACETIME_INDEX64
+using index_type = uint64_t;
+using sindex_type = int64_t;
+#else
 using index_type = uint32_t;
 using sindex_type = int32_t;
+#endif
 
 } /* end namespace spacetime */
 
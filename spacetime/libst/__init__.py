@@ -13,10 +13,22 @@ from ._core import (
     Celm,
     Selm,
     Kernel,
+    Boundary,
+    BoundaryType,
+    MarchTask,
     Solver,
     SolverProxy,
     InviscidBurgersSolver,
+    EulerSolver,
     LinearScalarSolver,
+    LinearScalarEnsemble,
+    InviscidBurgersEnsemble,
+    LinearScalarEnsembleF32,
+    LinearScalarEnsembleMixed,
+    InviscidBurgersEnsembleF32,
+    InviscidBurgersEnsembleMixed,
+    LinearScalarSolverF32,
+    InviscidBurgersSolverF32,
 )
 
 from ._pstcanvas import (
@@ -30,10 +42,22 @@ __all__ = [
     'Celm',
     'Selm',
     'Kernel',
+    'Boundary',
+    'BoundaryType',
+    'MarchTask',
     'Solver',
     'SolverProxy',
     'InviscidBurgersSolver',
+    'EulerSolver',
     'LinearScalarSolver',
+    'LinearScalarEnsemble',
+    'InviscidBurgersEnsemble',
+    'LinearScalarEnsembleF32',
+    'LinearScalarEnsembleMixed',
+    'InviscidBurgersEnsembleF32',
+    'InviscidBurgersEnsembleMixed',
+    'LinearScalarSolverF32',
+    'InviscidBurgersSolverF32',
     # _pstcanvas
     'PstCanvas',
 ]
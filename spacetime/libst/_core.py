@@ -7,14 +7,29 @@ Core entities for :py:mod:`libst` library.
 """
 
 
+import atexit
+import asyncio
+
 from ._libst import (
     Grid,
     Celm,
     Selm,
     Kernel,
+    Boundary,
+    BoundaryType,
+    MarchTask,
     Solver,
     InviscidBurgersSolver,
+    EulerSolver,
     LinearScalarSolver,
+    LinearScalarEnsemble,
+    InviscidBurgersEnsemble,
+    LinearScalarEnsembleF32,
+    LinearScalarEnsembleMixed,
+    InviscidBurgersEnsembleF32,
+    InviscidBurgersEnsembleMixed,
+    LinearScalarSolverF32,
+    InviscidBurgersSolverF32,
 )
 
 
@@ -23,13 +38,45 @@ __all__ = [
     'Celm',
     'Selm',
     'Kernel',
+    'Boundary',
+    'BoundaryType',
+    'MarchTask',
     'Solver',
     'SolverProxy',
     'InviscidBurgersSolver',
+    'EulerSolver',
     'LinearScalarSolver',
+    'LinearScalarEnsemble',
+    'InviscidBurgersEnsemble',
+    'LinearScalarEnsembleF32',
+    'LinearScalarEnsembleMixed',
+    'InviscidBurgersEnsembleF32',
+    'InviscidBurgersEnsembleMixed',
+    'LinearScalarSolverF32',
+    'InviscidBurgersSolverF32',
 ]
 
 
+def _await_march_task(self):
+    """
+    Wait for the march in a worker thread of the event loop, so that
+    ``await solver.march_alpha2_async(steps)`` does not block the other
+    coroutines.  Return the task, or raise the error of the march.
+    """
+
+    async def _wait():
+        await asyncio.get_running_loop().run_in_executor(None, self.result)
+        return self
+
+    return _wait().__await__()
+
+
+MarchTask.__await__ = _await_march_task
+
+# Stop the marching threads before the interpreter finalizes.
+atexit.register(MarchTask.cancel_all)
+
+
 class SolverProxy():
 
     def __init__(self, *args, **kw):
@@ -0,0 +1,70 @@
+# Copyright (c) 2020, Yung-Yu Chen <yyc@solvcon.net>
+# BSD 3-Clause License, see COPYING
+
+import unittest
+
+import numpy as np
+
+import libst
+
+
+class EulerSolverTC(unittest.TestCase):
+
+    @staticmethod
+    def _build_solver(resolution):
+
+        # Build grid.
+        xcrd = np.arange(resolution+1) / resolution
+        grid = libst.Grid(xcrd)
+
+        # Build solver.
+        svr = libst.EulerSolver(grid=grid, time_increment=1.e-3)
+        svr.left_boundary = libst.Boundary.extrapolate()
+        svr.right_boundary = libst.Boundary.extrapolate()
+
+        # Initialize with Sod's shock tube.
+        gamma = 1.4
+        rho = np.where(xcrd < 0.5, 1.0, 0.125)
+        p = np.where(xcrd < 0.5, 1.0, 0.1)
+        svr.set_so0(0, rho)
+        svr.set_so0(1, np.zeros_like(xcrd))
+        svr.set_so0(2, p / (gamma - 1))
+        for iv in range(3):
+            svr.set_so1(iv, np.zeros_like(xcrd))
+        svr.setup_march()
+
+        return xcrd, svr
+
+    def setUp(self):
+
+        self.resolution = 200
+        self.xcrd, self.svr = self._build_solver(self.resolution)
+
+    def test_nvar(self):
+
+        self.assertEqual(3, self.svr.nvar)
+
+    def test_shock_tube(self):
+
+        mass0 = self.svr.get_so0(0).ndarray.sum()
+        self.svr.march_alpha1(100)
+        rho = self.svr.get_so0(0).ndarray
+        self.assertGreater(rho.min(), 0.1)
+        self.assertLess(rho.max(), 1.01)
+        self.assertAlmostEqual(mass0, rho.sum(), delta=1.e-6*mass0)
+        self.assertGreater(self.svr.get_so0(2).ndarray.min(), 0)
+        self.assertLess(self.svr.get_cfl().ndarray.max(), 1)
+
+    def test_shock_tube_plateaus(self):
+
+        # Exact densities of Sod's problem at t = 0.2 between the rarefaction
+        # tail and the contact (0.486 < x < 0.686) and between the contact
+        # and the shock (0.686 < x < 0.850).  The solution is within 1%.
+        self.svr.march_alpha1(200)
+        rho = self.svr.get_so0(0).ndarray
+        left = (self.xcrd > 0.52) & (self.xcrd < 0.66)
+        right = (self.xcrd > 0.71) & (self.xcrd < 0.83)
+        np.testing.assert_allclose(rho[left], 0.426319, rtol=1.e-2)
+        np.testing.assert_allclose(rho[right], 0.265574, rtol=1.e-2)
+
+# vim: set et sw=4 ts=4:
@@ -74,6 +74,21 @@ class GridTC(unittest.TestCase):
         self.assertEqual(10, self.grid10.ncelm)
         self.assertEqual(11, self.grid10.nselm)
 
+    def test_geometry(self):
+
+        self.assertFalse(self.grid10.has_geometry)
+        self.grid10.build_geometry()
+        self.assertTrue(self.grid10.has_geometry)
+        self.assertTrue(self.grid10.adapt([1] * 10).has_geometry)
+        self.grid10.clear_geometry()
+        self.assertFalse(self.grid10.has_geometry)
+
+    def test_max_ncelm(self):
+
+        self.assertLess(2**30 - 5, libst.Grid.max_ncelm)
+        with self.assertRaisesRegex(OverflowError, "overflows sindex_type"):
+            libst.Grid(0, 1, libst.Grid.max_ncelm + 1)
+
     def test_str(self):
 
         self.assertEqual("Grid(xmin=0, xmax=10, ncelm=10)",
@@ -52,4 +52,45 @@ class InviscidBurgersSolverTC(unittest.TestCase):
             self.assertLessEqual(res.max(), 1)
             self.assertGreaterEqual(res.min(), -1)
 
+    def test_adaptive_time_step(self):
+
+        self.svr.target_cfl = 0.5
+        self.assertEqual(0.5, self.svr.target_cfl)
+        self.svr.march_alpha2(self.nstep)
+        self.svr.update_cfl(odd_plane=False)
+        self.assertEqual(self.svr.get_cfl().ndarray.max(), self.svr.cfl_max)
+        self.assertLess(self.svr.cfl_max, 0.6)
+
+    def test_adaptive_time_step_from_rest(self):
+
+        self.svr.set_so0(0, 1.e-8 * np.sin(self.xcrd))
+        self.svr.set_so1(0, 1.e-8 * np.cos(self.xcrd))
+        self.svr.setup_march()
+        self.svr.target_cfl = 0.8
+        self.assertEqual(1.2, self.svr.max_dt_growth)
+        dt = self.svr.time_increment
+        self.svr.march_alpha2(1)
+        # Not scaled to the target by the tiny CFL number at once.
+        self.assertAlmostEqual(dt * 1.2, self.svr.time_increment)
+        self.svr.max_time_increment = dt * 1.3
+        self.svr.march_alpha2(3)
+        self.assertEqual(dt * 1.3, self.svr.time_increment)
+        with self.assertRaisesRegex(ValueError, "< 1"):
+            self.svr.max_dt_growth = 0.9
+
+    def test_solver_float32(self):
+
+        svr = libst.InviscidBurgersSolverF32(
+            grid=self.svr.grid, time_increment=self.svr.time_increment)
+        svr.set_so0(0, np.sin(self.xcrd))
+        svr.set_so1(0, np.cos(self.xcrd))
+        svr.left_boundary = self.svr.left_boundary
+        svr.right_boundary = self.svr.right_boundary
+        svr.setup_march()
+        self.svr.march_alpha2(self.nstep)
+        svr.march_alpha2(self.nstep)
+        self.assertEqual(np.float32, svr.get_so0(0).ndarray.dtype)
+        self.assertTrue(np.allclose(self.svr.get_so0(0).ndarray,
+                                    svr.get_so0(0).ndarray, atol=1.e-5))
+
 # vim: set et sw=4 ts=4:
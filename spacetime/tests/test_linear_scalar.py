@@ -1,6 +1,9 @@
 # Copyright (c) 2018, Yung-Yu Chen <yyc@solvcon.net>
 # BSD 3-Clause License, see COPYING
 
+import asyncio
+import os
+import tempfile
 import unittest
 
 import numpy as np
@@ -111,6 +114,223 @@ class LinearScalarSolverTC(unittest.TestCase):
         np.testing.assert_allclose(self.svr.get_cfl(), ones,
                                    rtol=0, atol=1.e-14)
 
+    def test_march_sweep(self):
+
+        svr2 = self._build_solver(self.resolution)[-1]
+        self.assertTrue(svr2.has_sweep)
+        svr2.use_sweep = True
+        self.svr.march_alpha2(self.nstep*self.cycle)
+        svr2.march_alpha2(self.nstep*self.cycle)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         svr2.get_so0(0).ndarray.tolist())
+        self.assertEqual(self.svr.get_so1(0).ndarray.tolist(),
+                         svr2.get_so1(0).ndarray.tolist())
+
+    def test_march_fused(self):
+
+        svr2 = self._build_solver(self.resolution)[-1]
+        svr2.use_fused = True
+        svr2.use_sweep = True
+        self.svr.march_alpha2(self.nstep*self.cycle)
+        svr2.march_alpha2(self.nstep*self.cycle)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         svr2.get_so0(0).ndarray.tolist())
+        self.assertEqual(self.svr.get_so1(0).ndarray.tolist(),
+                         svr2.get_so1(0).ndarray.tolist())
+        self.assertEqual(self.svr.get_cfl(odd_plane=True).ndarray.tolist(),
+                         svr2.get_cfl(odd_plane=True).ndarray.tolist())
+
+    def test_march_block(self):
+
+        svr2 = self._build_solver(self.resolution)[-1]
+        svr2.block_steps = 4
+        svr2.tile_ncelm = 9
+        self.assertEqual(4, svr2.block_steps)
+        self.assertEqual(9, svr2.tile_ncelm)
+        self.svr.march_alpha2(self.nstep*self.cycle)
+        svr2.march_alpha2(self.nstep*self.cycle)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         svr2.get_so0(0).ndarray.tolist())
+        self.assertEqual(self.svr.get_so1(0).ndarray.tolist(),
+                         svr2.get_so1(0).ndarray.tolist())
+
+    def test_march_lts(self):
+
+        svr2 = self._build_solver(self.resolution)[-1]
+        ncelm = svr2.grid.ncelm
+        with self.assertRaisesRegex(ValueError, "!= ncelm"):
+            svr2.lts_coarse = [True] * (ncelm+1)
+        svr2.lts_coarse = [True] * ncelm
+        self.assertEqual([True] * ncelm, svr2.lts_coarse)
+        self.svr.march_alpha2(self.nstep*self.cycle)
+        svr2.march_lts_alpha2(self.nstep*self.cycle)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         svr2.get_so0(0).ndarray.tolist())
+        self.assertEqual(self.svr.get_so1(0).ndarray.tolist(),
+                         svr2.get_so1(0).ndarray.tolist())
+
+    def test_adapt(self):
+
+        ncelm = self.svr.grid.ncelm
+        flags = self.svr.adapt_flags(refine=0.3, coarsen=0.0)
+        self.assertEqual(ncelm, len(flags))
+        self.assertEqual([0, 1], sorted(set(flags)))
+        grid = self.svr.grid.adapt([1] * ncelm)
+        self.assertEqual(2*ncelm, grid.ncelm)
+        with self.assertRaisesRegex(ValueError, "!= ncelm"):
+            self.svr.grid.adapt([1])
+        self.svr.remesh(grid)
+        self.assertEqual(2*ncelm, self.svr.grid.ncelm)
+        self.svr.adapt([-1] * (2*ncelm))
+        self.assertEqual(ncelm, self.svr.grid.ncelm)
+        np.testing.assert_allclose(self.svr.get_so0(0).ndarray,
+                                   np.sin(self.svr.xctr()), atol=1.e-2)
+
+    def test_checkpoint(self):
+
+        self.svr.march_alpha2(self.nstep)
+        self.assertEqual(self.nstep, self.svr.step)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "svr.ckpt")
+            self.svr.write_checkpoint(path)
+            svr2 = self._build_solver(self.resolution*2)[-1]
+            svr2.read_checkpoint(path)
+        self.assertEqual(self.resolution, svr2.grid.ncelm)
+        self.assertEqual(self.nstep, svr2.step)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         svr2.get_so0(0).ndarray.tolist())
+        with self.assertRaisesRegex(RuntimeError, "cannot open"):
+            svr2.read_checkpoint(path)
+
+    def test_output(self):
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "svr.snap")
+            self.svr.open_output(path, 2)
+            self.assertEqual(2, self.svr.output_interval)
+            self.svr.march_alpha2(4)
+            self.svr.close_output()
+            self.assertEqual(0, self.svr.output_interval)
+            with open(path, "rb") as fobj:
+                buf = fobj.read()
+        self.assertEqual(b"LIBSTSNP", buf[:8])
+        steps = []
+        pos = 16
+        while pos < len(buf):
+            step, _, ncelm, nvar, xsize = np.frombuffer(
+                buf, dtype="u8", count=5, offset=pos)
+            self.assertEqual(self.resolution, ncelm)
+            self.assertEqual(1, nvar)
+            steps.append(int(step))
+            so0 = np.frombuffer(buf, dtype="float64", count=int(xsize),
+                                offset=pos + 40 + 8 * int(xsize))
+            pos += 40 + 8 * int(xsize) * 3
+        self.assertEqual([2, 4], steps)
+        # SEs on the even plane are at the even indices after the 2 ghosts.
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         so0[2:-2:2].tolist())
+
+    def test_profile(self):
+
+        self.svr.reset_profile()
+        self.svr.march_alpha2(3)
+        prof = self.svr.profile()
+        self.assertEqual(
+            {"so0", "cfl", "so1", "boundary", "fused", "block", "lts"},
+            set(prof.keys()))
+        if not libst.LinearScalarSolver.profile_enabled:
+            self.assertEqual(0, prof["so0"]["ncall"])
+            return
+        self.assertEqual(6, prof["so0"]["ncall"])
+        self.assertEqual(3 * (2 * self.resolution + 1), prof["so0"]["nelm"])
+        self.assertLessEqual(0.0, prof["so0"]["throughput"])
+        self.svr.reset_profile()
+        self.assertEqual(0, self.svr.profile()["so0"]["ncall"])
+
+    def test_boundary(self):
+
+        self.assertEqual(libst.BoundaryType.PERIODIC,
+                         self.svr.left_boundary.type)
+        self.svr.left_boundary = libst.Boundary.dirichlet([2.0])
+        self.svr.right_boundary = libst.Boundary.reflect(signs=[-1.0])
+        self.assertEqual([2.0], self.svr.left_boundary.values)
+        with self.assertRaisesRegex(ValueError, "!= nvar"):
+            self.svr.left_boundary = libst.Boundary.dirichlet([1.0, 2.0])
+
+        self.svr.march_half1_alpha2()
+        ncelm = self.svr.grid.ncelm
+        left_out = self.svr.selm(-1, odd_plane=True)
+        right_in = self.svr.selm(ncelm-1, odd_plane=True)
+        right_out = self.svr.selm(ncelm, odd_plane=True)
+        self.assertEqual(2.0, left_out.get_so0(0))
+        self.assertEqual(0.0, left_out.get_so1(0))
+        self.assertEqual(-right_in.get_so0(0), right_out.get_so0(0))
+        self.assertEqual(right_in.get_so1(0), right_out.get_so1(0))
+
+        def _treat(ghost, inner, order):
+            if 0 == order:
+                ghost.set_so0(0, 5.0)
+            else:
+                ghost.set_so1(0, inner.get_so1(0))
+
+        self.svr.left_boundary = libst.Boundary.callback(_treat)
+        self.svr.march_half2_alpha2()
+        self.svr.march_half1_alpha2()
+        self.assertEqual(5.0, left_out.get_so0(0))
+        self.assertEqual(self.svr.selm(0, odd_plane=True).get_so1(0),
+                         left_out.get_so1(0))
+
+    def test_view(self):
+
+        so0 = self.svr.view_so0(0)
+        so1 = self.svr.view_so1(0, odd_plane=True)
+        cfl = self.svr.view_cfl()
+        self.assertFalse(so0.flags.writeable)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(), so0.tolist())
+        self.assertEqual(self.svr.get_cfl().ndarray.tolist(), cfl.tolist())
+        self.assertEqual(len(so1), self.svr.grid.ncelm)
+
+        # The views follow the solution without being fetched again.
+        self.svr.march_alpha2(self.nstep)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(), so0.tolist())
+        self.assertEqual(self.svr.get_so1(0, odd_plane=True).ndarray.tolist(),
+                         so1.tolist())
+        self.assertEqual(self.svr.get_cfl().ndarray.tolist(), cfl.tolist())
+
+        with self.assertRaisesRegex(IndexError, "out of nvar range"):
+            self.svr.view_so0(1)
+
+        # The views own the arrays they were made from, after the solver
+        # reallocates them or is gone.
+        values = so0.tolist()
+        whole = self.svr.so0
+        whole_values = whole.ndarray.tolist()
+        self.svr.place_memory()
+        self.assertEqual(values, so0.tolist())
+        self.assertEqual(whole_values, whole.ndarray.tolist())
+        cfl = self._build_solver(self.resolution)[2].view_cfl()
+        self.assertEqual(self.svr.grid.nselm, len(cfl))
+
+    def test_set_bulk(self):
+
+        nselm = self.svr.grid.nselm
+        val = np.arange(2*nselm, dtype='float64')
+        # Strided input is read in place.
+        self.svr.set_so0(0, val[::2])
+        self.assertEqual(val[::2].tolist(), self.svr.get_so0(0).ndarray.tolist())
+        # All variables at once from a (nselm, nvar) array.
+        self.svr.set_so1(val[1::2].reshape((nselm, 1)))
+        self.assertEqual(val[1::2].tolist(),
+                         self.svr.get_so1(0).ndarray.tolist())
+        self.svr.set_cfl(np.full(nselm-1, 0.5), odd_plane=True)
+        self.assertEqual([0.5]*(nselm-1),
+                         self.svr.get_cfl(odd_plane=True).ndarray.tolist())
+
+        with self.assertRaisesRegex(IndexError, "arr columns 2 != nvar 1"):
+            self.svr.set_so0(np.zeros((nselm, 2)))
+        with self.assertRaisesRegex(IndexError, "arr size 3 != nselm"):
+            self.svr.set_so0(0, np.zeros(3))
+
     def test_march_fine_interface(self):
 
         def _march():
@@ -134,6 +354,159 @@ class LinearScalarSolverTC(unittest.TestCase):
             self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
                              svr2.get_so0(0).ndarray.tolist())
 
+    def test_place_memory(self):
+
+        svr2 = self._build_solver(self.resolution)[-1]
+        svr2.nthread = 2
+        svr2.place_memory()
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         svr2.get_so0(0).ndarray.tolist())
+        self.svr.march_alpha2(self.nstep)
+        svr2.march_alpha2(self.nstep)
+        self.assertEqual(self.svr.get_so0(0).ndarray.tolist(),
+                         svr2.get_so0(0).ndarray.tolist())
+
+        # Arrays of an ensemble taken before keep the old memory.
+        ens = libst.LinearScalarEnsemble(
+            grid=self.svr.grid, nmember=2,
+            time_increment=self.svr.time_increment)
+        ens.set_so0(np.ones((self.svr.grid.nselm, 2)))
+        so0 = ens.so0.ndarray
+        values = so0.tolist()
+        ens.place_memory()
+        self.assertEqual(values, so0.tolist())
+        self.assertEqual(values, ens.so0.ndarray.tolist())
+
+    def test_march_async(self):
+
+        svr2 = self._build_solver(self.resolution)[-1]
+        task = self.svr.march_alpha2_async(steps=self.nstep, chunk=3)
+        self.assertTrue(task.wait())
+        task.result()
+        self.assertTrue(task.done)
+        self.assertFalse(task.cancelled)
+        self.assertEqual(self.nstep, task.progress)
+        svr2.march_alpha2(steps=self.nstep)
+        self.assertEqual(svr2.get_so0(0).ndarray.tolist(),
+                         self.svr.get_so0(0).ndarray.tolist())
+
+        async def _march():
+            return await svr2.march_alpha2_async(steps=2)
+
+        loop = asyncio.new_event_loop()
+        try:
+            task = loop.run_until_complete(_march())
+        finally:
+            loop.close()
+        self.assertEqual(2, task.progress)
+        self.assertEqual(self.nstep + 2, svr2.step)
+
+    def test_march_async_busy(self):
+
+        task = self.svr.march_alpha2_async(steps=10**9)
+        try:
+            msg = "marching asynchronously"
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.remesh(self.svr.grid)
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.place_memory()
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.set_so0(0, np.zeros(self.svr.grid.nselm))
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.so0
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.view_so0(0)
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.march_alpha2(1)
+            with self.assertRaisesRegex(RuntimeError, "already marched"):
+                self.svr.march_alpha2_async(steps=1)
+            # The grid is read by the march, for all the solvers sharing it.
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.grid.build_geometry()
+            with self.assertRaisesRegex(RuntimeError, msg):
+                self.svr.grid.clear_geometry()
+        finally:
+            task.cancel()
+            task.wait()
+        # The solver is free once the task is done.
+        self.svr.place_memory()
+        self.svr.grid.build_geometry()
+        self.svr.grid.clear_geometry()
+        self.assertEqual(self.svr.grid.nselm, len(self.svr.get_so0(0).ndarray))
+
+    def test_ensemble(self):
+
+        nmember = 3
+        ens = libst.LinearScalarEnsemble(
+            grid=self.svr.grid, nmember=nmember,
+            time_increment=self.svr.time_increment)
+        self.assertEqual(nmember, ens.nmember)
+        amp = np.arange(1, nmember+1) / nmember
+        ens.set_so0(np.sin(self.xcrd)[:, None] * amp[None, :])
+        ens.set_so1(np.cos(self.xcrd)[:, None] * amp[None, :])
+        ens.set_time_increment(2, self.svr.time_increment / 2)
+        ens.setup_march()
+        ens.march_alpha2(self.nstep)
+        self.assertEqual(self.nstep, ens.step)
+
+        for im in range(nmember):
+            svr = self._build_solver(self.resolution)[-1]
+            svr.set_so0(0, np.sin(self.xcrd) * amp[im])
+            svr.set_so1(0, np.cos(self.xcrd) * amp[im])
+            svr.time_increment = ens.time_increment(im)
+            svr.setup_march()
+            svr.march_alpha2(self.nstep)
+            self.assertEqual(svr.get_so0(0).ndarray.tolist(),
+                             ens.get_so0(im).ndarray.tolist())
+
+        with self.assertRaisesRegex(IndexError, "input not"):
+            ens.set_so0(np.zeros((self.resolution+1, nmember+1)))
+
+    def test_ensemble_float32(self):
+
+        nmember = 2
+        so0 = np.sin(self.xcrd)[:, None] * np.ones(nmember)[None, :]
+        so1 = np.cos(self.xcrd)[:, None] * np.ones(nmember)[None, :]
+        sols = []
+        for cls in (libst.LinearScalarEnsemble, libst.LinearScalarEnsembleF32,
+                    libst.LinearScalarEnsembleMixed):
+            ens = cls(grid=self.svr.grid, nmember=nmember,
+                      time_increment=self.svr.time_increment)
+            ens.set_so0(so0)
+            ens.set_so1(so1)
+            ens.setup_march()
+            ens.march_alpha2(self.nstep)
+            sols.append(ens.get_so0(0).ndarray)
+        self.assertEqual(np.float32, sols[1].dtype)
+        self.assertEqual(np.float32, sols[2].dtype)
+        self.assertTrue(np.allclose(sols[0], sols[1], atol=1.e-5))
+        self.assertTrue(np.allclose(sols[0], sols[2], atol=1.e-5))
+
+    def test_solver_float32(self):
+
+        svr = libst.LinearScalarSolverF32(
+            grid=self.svr.grid, time_increment=self.svr.time_increment)
+        self.assertEqual(1, svr.nvar)
+        svr.set_so0(0, np.sin(self.xcrd))
+        svr.set_so1(0, np.cos(self.xcrd))
+        svr.setup_march()
+        svr.march_alpha2(self.nstep)
+        self.assertEqual(self.nstep, svr.step)
+        self.svr.march_alpha2(self.nstep)
+
+        so0 = svr.get_so0(0).ndarray
+        self.assertEqual(np.float32, so0.dtype)
+        self.assertEqual(np.float32, svr.so0.ndarray.dtype)
+        self.assertTrue(np.allclose(self.svr.get_so0(0).ndarray, so0,
+                                    atol=1.e-5))
+        self.assertAlmostEqual(self.svr.cfl_max, svr.cfl_max, places=5)
+
+        with self.assertRaisesRegex(IndexError, "input not 1D"):
+            svr.set_so0(0, np.zeros((self.resolution+1, 2)))
+        with self.assertRaisesRegex(ValueError, "callback"):
+            svr.left_boundary = libst.Boundary.callback(lambda *args: None)
+
+
 
 class LinearScalarGridTestTC(unittest.TestCase):
     """
@@ -56,6 +56,12 @@ class SolverTC(unittest.TestCase):
 
         self.assertEqual(1, self.sol10.nvar)
 
+    def test_nthread(self):
+
+        self.assertEqual(1, self.sol10.nthread)
+        with self.assertRaisesRegex(ValueError, "only marches in one thread"):
+            self.sol10.nthread = 2
+
     def test_time_increment(self):
 
         self.assertEqual(0.2, self.sol10.time_increment)
@@ -367,6 +373,186 @@ class PythonCustomSolverTC(unittest.TestCase):
                              svr2.get_so0(0).ndarray.tolist())
 
 
+class PythonPlaneSolverTC(unittest.TestCase):
+
+    @staticmethod
+    def _build_solver(resolution, solver_type=libst.Solver):
+
+        # Build grid.
+        xcrd = np.arange(resolution+1) / resolution
+        xcrd *= 2 * np.pi
+        grid = libst.Grid(xcrd)
+        dx = (grid.xmax - grid.xmin) / grid.ncelm
+
+        # Build solver.
+        time_stop = 2*np.pi
+        cfl_max = 1.0
+        dt_max = dx * cfl_max
+        nstep = int(np.ceil(time_stop / dt_max))
+        dt = time_stop / nstep
+        if solver_type is libst.Solver:
+            svr = libst.Solver(grid=grid, time_increment=dt, nvar=1)
+        else:
+            svr = solver_type(grid=grid, time_increment=dt)
+
+        if solver_type is libst.Solver:
+            # Customize to linear wave solver with whole-plane hooks.
+            hdt = dt / 2
+            qdt = dt / 4
+
+            def _geom(x, dxneg, dxpos):
+                x, dxneg, dxpos = x[:, None], dxneg[:, None], dxpos[:, None]
+                return x, dxneg, dxpos, x + 0.5 * (dxpos - dxneg)
+
+            def xn(so0, so1, x, dxneg, dxpos):
+                x, dxneg, dxpos, xctr = _geom(x, dxneg, dxpos)
+                displacement = x - 0.5 * dxneg - xctr
+                return dxneg * (so0 + displacement * so1)
+            svr.kernel.xn_plane_calc = xn
+
+            def xp(so0, so1, x, dxneg, dxpos):
+                x, dxneg, dxpos, xctr = _geom(x, dxneg, dxpos)
+                displacement = x + 0.5 * dxpos - xctr
+                return dxpos * (so0 + displacement * so1)
+            svr.kernel.xp_plane_calc = xp
+
+            def tn(so0, so1, x, dxneg, dxpos):
+                x, dxneg, dxpos, xctr = _geom(x, dxneg, dxpos)
+                return hdt * (so0 + (x - xctr) * so1 + qdt * so1)
+            svr.kernel.tn_plane_calc = tn
+
+            def tp(so0, so1, x, dxneg, dxpos):
+                x, dxneg, dxpos, xctr = _geom(x, dxneg, dxpos)
+                return hdt * (so0 + (x - xctr) * so1 - qdt * so1)
+            svr.kernel.tp_plane_calc = tp
+
+            def so0p(so0, so1, x, dxneg, dxpos):
+                x, dxneg, dxpos, xctr = _geom(x, dxneg, dxpos)
+                return so0 + (x - xctr) * so1 - hdt * so1
+            svr.kernel.so0p_plane_calc = so0p
+
+            def cfl(so0, so1, x, dxneg, dxpos):
+                return hdt / np.minimum(dxneg, dxpos)
+            svr.kernel.cfl_plane_updater = cfl
+
+        # Initialize.
+        svr.set_so0(0, np.sin(xcrd))
+        svr.set_so1(0, np.cos(xcrd))
+        svr.setup_march()
+
+        return nstep, xcrd, svr
+
+    def setUp(self):
+
+        self.resolution = 8
+        self.nstep, self.xcrd, self.svr = self._build_solver(self.resolution)
+        self.cycle = 10
+
+    def test_march(self):
+
+        svr2 = self._build_solver(self.resolution,
+                                  solver_type=libst.LinearScalarSolver)[-1]
+        self.svr.march_alpha2(self.nstep*self.cycle)
+        svr2.march_alpha2(self.nstep*self.cycle)
+        np.testing.assert_allclose(self.svr.get_so0(0), svr2.get_so0(0),
+                                   rtol=0, atol=1.e-12)
+        np.testing.assert_allclose(self.svr.get_cfl(), svr2.get_cfl(),
+                                   rtol=0, atol=1.e-14)
+
+    def test_march_async(self):
+
+        # The plane hooks take the GIL in the marching thread.
+        svr2 = self._build_solver(self.resolution)[-1]
+        task = self.svr.march_alpha2_async(self.nstep)
+        self.assertTrue(task.wait())
+        task.result()
+        svr2.march_alpha2(self.nstep)
+        self.assertEqual(svr2.get_so0(0).ndarray.tolist(),
+                         self.svr.get_so0(0).ndarray.tolist())
+
+        # The hooks may be released by the thread.
+        task = self._build_solver(self.resolution)[-1].march_alpha2_async(2)
+        task.result()
+        self.assertEqual(2, task.progress)
+
+    def test_readonly_view(self):
+
+        def xn(so0, so1, x, dxneg, dxpos):
+            so0[0, 0] = 1.0
+        self.svr.kernel.xn_plane_calc = xn
+        with self.assertRaisesRegex(ValueError, "read-only"):
+            self.svr.march_alpha2(1)
+
+    def test_kept_arguments(self):
+
+        kept = []
+        xn = self.svr.kernel.xn_plane_calc
+
+        def keep(so0, so1, x, dxneg, dxpos):
+            kept.append((so0, so1, x))
+            return xn(so0, so1, x, dxneg, dxpos)
+        self.svr.kernel.xn_plane_calc = keep
+        self.svr.march_alpha2(1)
+        values = [arr.tolist() for arr in kept[-1]]
+        # The arguments kept by the hook own the arrays reallocated here.
+        self.svr.place_memory()
+        self.assertEqual(values, [arr.tolist() for arr in kept[-1]])
+
+    def test_coordinate_views(self):
+
+        kept = []
+        xn = self.svr.kernel.xn_plane_calc
+
+        def keep(so0, so1, x, dxneg, dxpos):
+            kept.append((x, dxneg, dxpos))
+            return xn(so0, so1, x, dxneg, dxpos)
+        self.svr.kernel.xn_plane_calc = keep
+        self.svr.march_alpha2(2)
+        # The coordinates of a plane are built once for the grid and passed
+        # as read-only views.
+        x0, dxneg0, dxpos0 = kept[0]
+        x2, dxneg2, dxpos2 = kept[2]
+        self.assertTrue(np.shares_memory(x0, x2))
+        self.assertFalse(x0.flags.writeable)
+        self.assertEqual(x0.tolist(), x2.tolist())
+        self.assertEqual(dxpos0.tolist(), dxpos2.tolist())
+        np.testing.assert_allclose(x0[1:] - x0[:-1], dxneg0[1:] + dxpos0[:-1])
+
+    def test_on_demand(self):
+
+        ncall = []
+        xn = self.svr.kernel.xn_plane_calc
+
+        def count(so0, so1, x, dxneg, dxpos):
+            ncall.append(len(x))
+            return xn(so0, so1, x, dxneg, dxpos)
+        self.svr.kernel.xn_plane_calc = count
+        # One evaluation serves the element calls on a plane.
+        values = [se.xn(0) for se in self.svr.selms(odd_plane=False)]
+        self.assertEqual(1, len(ncall))
+        # Setting the solution drops it.
+        se = self.svr.selm(3)
+        se.set_so0(0, se.get_so0(0) + 1)
+        self.assertNotEqual(values[3], self.svr.selm(3).xn(0))
+        self.assertEqual(2, len(ncall))
+
+    def test_wrong_size(self):
+
+        def xn(so0, so1, x, dxneg, dxpos):
+            return np.zeros(len(x)+1)
+        self.svr.kernel.xn_plane_calc = xn
+        with self.assertRaisesRegex(ValueError, "result size"):
+            self.svr.march_alpha2(1)
+
+    def test_reset(self):
+
+        self.assertIsNotNone(self.svr.kernel.xn_plane_calc)
+        self.svr.kernel.xn_plane_calc = None
+        self.assertIsNone(self.svr.kernel.xn_plane_calc)
+        self.svr.kernel.reset()
+        self.assertIsNone(self.svr.kernel.cfl_plane_updater)
+
+
 class LinearProxy(libst.SolverProxy):
 
     def _xn_calc(self, se, iv):